@@ -155,6 +155,39 @@ else()
 endif()
 
 
+############################################################################################
+# FFTW (optional, needed for the fft pressure solver only, which is compiled out without it;
+# the search can be skipped with -DUSE_FFTW=OFF)
+if(NOT DEFINED USE_FFTW OR USE_FFTW)
+  find_path(FFTW_INCLUDE_DIR NAMES fftw3.h)
+  find_library(FFTW_LIBRARY NAMES fftw3)
+  find_library(FFTWF_LIBRARY NAMES fftw3f)
+endif()
+if((NOT DEFINED USE_FFTW OR USE_FFTW) AND FFTW_INCLUDE_DIR AND FFTW_LIBRARY)
+  set(USE_FFTW TRUE)
+  set(libmpdataxx_CXX_FLAGS_DEBUG "${libmpdataxx_CXX_FLAGS_DEBUG} -DUSE_FFTW")
+  set(libmpdataxx_CXX_FLAGS_RELEASE "${libmpdataxx_CXX_FLAGS_RELEASE} -DUSE_FFTW")
+  set(libmpdataxx_LIBRARIES "${libmpdataxx_LIBRARIES};${FFTW_LIBRARY}")
+  if(FFTWF_LIBRARY)
+    # single precision (needed for the fft pressure solver with real_t = float)
+    set(libmpdataxx_CXX_FLAGS_DEBUG "${libmpdataxx_CXX_FLAGS_DEBUG} -DUSE_FFTWF")
+    set(libmpdataxx_CXX_FLAGS_RELEASE "${libmpdataxx_CXX_FLAGS_RELEASE} -DUSE_FFTWF")
+    set(libmpdataxx_LIBRARIES "${libmpdataxx_LIBRARIES};${FFTWF_LIBRARY}")
+  endif()
+  set(libmpdataxx_INCLUDE_DIRS "${libmpdataxx_INCLUDE_DIRS};${FFTW_INCLUDE_DIR}")
+elseif(NOT DEFINED USE_FFTW OR USE_FFTW)
+  set(USE_FFTW FALSE)
+  message(STATUS "FFTW not found.
+
+* Programs using libmpdata++'s fft pressure solver will not compile.
+* To install FFTW, please try:
+*   Debian/Ubuntu: sudo apt-get install libfftw3-dev
+*   Fedora: sudo yum install fftw-devel
+*   Homebrew: brew install fftw
+  ")
+endif()
+
+
 ############################################################################################
 # gnuplot-iostream
 find_path(GNUPLOT-IOSTREAM_INCLUDE_DIR PATH_SUFFIXES gnuplot-iostream/ NAMES gnuplot-iostream.h)
@@ -184,6 +217,37 @@ else()
 endif()
 
 
+############################################################################################
+# MPI (enabled if the C++ compiler is an MPI wrapper, e.g. -DCMAKE_CXX_COMPILER=mpic++)
+check_cxx_source_compiles("
+  #include <mpi.h>
+  int main() { MPI_Finalize(); }
+" USE_MPI)
+if(USE_MPI)
+  find_package(Boost COMPONENTS mpi serialization)
+  if(Boost_FOUND)
+    set(libmpdataxx_CXX_FLAGS_DEBUG "${libmpdataxx_CXX_FLAGS_DEBUG} -DUSE_MPI")
+    set(libmpdataxx_CXX_FLAGS_RELEASE "${libmpdataxx_CXX_FLAGS_RELEASE} -DUSE_MPI")
+    set(libmpdataxx_LIBRARIES "${libmpdataxx_LIBRARIES};${Boost_LIBRARIES}")
+    if(USE_FFTW)
+      message(STATUS "MPI enabled.
+
+* Programs using libmpdata++'s fft pressure solver will not compile (no MPI support).
+      ")
+    endif()
+  else()
+    set(USE_MPI FALSE)
+    message(STATUS "Boost.MPI not found.
+
+* Programs using libmpdata++ will run on a single MPI process only.
+* To install Boost.MPI, please try:
+*   Debian/Ubuntu: sudo apt-get install libboost-mpi-dev
+*   Fedora: sudo yum install boost-openmpi-devel
+    ")
+  endif()
+endif()
+
+
 ############################################################################################
 list(REMOVE_DUPLICATES libmpdataxx_INCLUDE_DIRS)
 list(REMOVE_ITEM libmpdataxx_INCLUDE_DIRS "")
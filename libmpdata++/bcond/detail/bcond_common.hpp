@@ -14,7 +14,7 @@ namespace libmpdataxx
   {
     using namespace arakawa_c;
 
-    enum bcond_e { null, cyclic, polar, open, rigid, gndsky, custom }; 
+    enum bcond_e { null, cyclic, polar, open, rigid, gndsky, custom, remote }; 
     enum drctn_e { left, rght };
 
     template<
@@ -175,6 +175,20 @@ namespace libmpdataxx
         virtual void fill_halos_flux(arrvec_t<blitz::Array<real_t, 3>> &, const rng_t &, const rng_t &) 
 	{};
 
+	// true if fill_halos_flux() sets the flux through the edge to minus the flux
+	// through the neighbouring interior cell face (zero-flux condition)
+	virtual bool mirror_flux() const
+	{
+	  return false;
+	}
+
+	// true if set_edge_pres() with sign = 0 zeroes the pressure gradient at the edge
+	// and fill_halos_pres() extrapolates it beyond the edge as an odd function (zero-flux condition)
+	virtual bool mirror_pres() const
+	{
+	  return false;
+	}
+
 	protected:
 	  // sclr
 	int 
@@ -0,0 +1,104 @@
+// common code for the "remote" boundary conditions, i.e. halo exchanges
+// with subdomains owned by other MPI processes
+//
+// licensing: GPU GPL v3
+// copyright: University of Warsaw
+
+#pragma once
+
+#include <libmpdata++/bcond/detail/bcond_common.hpp>
+#include <libmpdata++/concurr/detail/distmem.hpp>
+
+#if defined(USE_MPI)
+#  include <boost/mpi/nonblocking.hpp>
+#endif
+
+namespace libmpdataxx
+{
+  namespace bcond
+  {
+    namespace detail
+    {
+      template <typename real_t, int halo, drctn_e dir, int n_dims>
+      class remote_common : public bcond_common<real_t, halo>
+      {
+        using parent_t = bcond_common<real_t, halo>;
+
+        protected:
+
+        using arr_t = blitz::Array<real_t, n_dims>;
+
+        private:
+
+#if defined(USE_MPI)
+        boost::mpi::communicator mpicom;
+#endif
+        const int peer, msg_send, msg_recv;
+
+        // the points sent to the peer: at the periodic domain edge the same as sent by 
+        // the cyclic bcond (i.e. skipping the edge point, the first and the last points 
+        // of a periodic domain being the same one), at the edges between the processes' 
+        // parts of the domain the first (or last) halo points (as read through shared memory)
+        const rng_t intr_sclr_, intr_vctr_;
+
+        protected:
+
+        // the interior next to the edge is sent to the peer and its data received into the halo
+        const rng_t &intr_sclr() const { return intr_sclr_; }
+        const rng_t &halo_sclr() const { return dir == left ? this->left_halo_sclr : this->rght_halo_sclr; }
+        const rng_t &intr_vctr() const { return intr_vctr_; }
+        const rng_t &halo_vctr() const { return dir == left ? this->left_halo_vctr : this->rght_halo_vctr; }
+
+        // a BLOCKING exchange through contiguous buffers: returns only once both the send and 
+        // the receive have completed (irecv/isend are used only so that the pair cannot deadlock
+        // on the message order, no communication is overlapped with computation; the peers
+        // have to call xchng() for the matching edges in a matching order, see solver_common)
+        void xchng(arr_t &a, const idx_t<n_dims> &idx_send, const idx_t<n_dims> &idx_recv)
+        {
+#if defined(USE_MPI)
+          const arr_t buf_send(a(idx_send).copy());
+          // same (default) storage order as the peer's copy(), the halo not read
+          arr_t buf_recv(a(idx_recv).lbound(), a(idx_recv).extent());
+          boost::mpi::request reqs[2] = {
+            mpicom.irecv(peer, msg_recv, buf_recv.dataFirst(), buf_recv.numElements()),
+            mpicom.isend(peer, msg_send, buf_send.dataFirst(), buf_send.numElements())
+          };
+          boost::mpi::wait_all(reqs, reqs + 2);
+          a(idx_recv) = buf_recv;
+#else
+          assert(false && "remote bcond used without USE_MPI");
+#endif
+        }
+
+        public:
+
+        // ctor
+        remote_common(
+          const rng_t &i,
+          const int grid_size_0,
+          const concurr::detail::distmem &distmem,
+          const int peer, // rank of the process on the other side of the edge
+          const int tag,  // distinguishes subdomains along the edge (i.e. threads)
+          const bool periodic // true if the edge is also the periodic domain edge
+        ) :
+          parent_t(i, grid_size_0),
+#if defined(USE_MPI)
+          mpicom(distmem.comm()),
+#endif
+          peer(peer),
+          // leftward messages get even tags, rightward ones odd tags
+          msg_send(2 * tag + (dir == left ? 0 : 1)),
+          msg_recv(2 * tag + (dir == left ? 1 : 0)),
+          intr_sclr_(
+            periodic ? (dir == left ? this->left_intr_sclr : this->rght_intr_sclr) :
+            dir == left ? rng_t(i.first(), i.first() + halo - 1) : rng_t(i.last() - (halo - 1), i.last())
+          ),
+          intr_vctr_(
+            periodic ? (dir == left ? this->left_intr_vctr : this->rght_intr_vctr) :
+            dir == left ? rng_t((i^h).first(), (i^h).first() + halo - 1) : rng_t((i^h).last() - (halo - 1), (i^h).last())
+          )
+        {}
+      };
+    } // namespace detail
+  } // namespace bcond
+} // namespace libmpdataxx
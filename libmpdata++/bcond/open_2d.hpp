@@ -70,6 +70,11 @@ namespace libmpdataxx
         }
       }
 
+      bool mirror_pres() const
+      {
+        return true;
+      }
+
       void fill_halos_vctr_alng(arrvec_t<arr_t> &av, const rng_t &j, const bool ad = false)
       {
 	using namespace idxperm;
@@ -162,6 +167,11 @@ namespace libmpdataxx
         a(pi<d>(this->rght_edge_sclr, j)) = sign * edge_velocity(pi<d>(0, j));
       }
 
+      bool mirror_pres() const
+      {
+        return true;
+      }
+
       void fill_halos_vctr_alng(arrvec_t<arr_t> &av, const rng_t &j, const bool ad = false)
       {
 	using namespace idxperm;
@@ -69,6 +69,11 @@ namespace libmpdataxx
         a(pi<d>(this->left_edge_sclr, j, k)) = sign * edge_velocity(pi<d>(0, j, k));
       }
 
+      bool mirror_pres() const
+      {
+        return true;
+      }
+
       void fill_halos_vctr_alng(arrvec_t<arr_t> &av, const rng_t &j, const rng_t &k, const bool ad = false)
       {
 	using namespace idxperm;
@@ -181,6 +186,11 @@ namespace libmpdataxx
         a(pi<d>(this->rght_edge_sclr, j, k)) = sign * edge_velocity(pi<d>(0, j, k));
       }
 
+      bool mirror_pres() const
+      {
+        return true;
+      }
+
       void fill_halos_vctr_alng(arrvec_t<arr_t> &av, const rng_t &j, const rng_t &k, const bool ad = false)
       {
 	using namespace idxperm;
@@ -0,0 +1,44 @@
+// 1D remote (MPI) boundary conditions for libmpdata++
+//
+// licensing: GPU GPL v3
+// copyright: University of Warsaw
+
+#pragma once
+
+#include <libmpdata++/bcond/detail/remote_common.hpp>
+
+namespace libmpdataxx
+{
+  namespace bcond
+  {
+    template <typename real_t, int halo, bcond_e knd, drctn_e dir, int n_dims, int dim>
+    class bcond<       real_t,     halo,         knd,         dir,     n_dims,     dim,
+      typename std::enable_if<
+        knd == remote &&
+        n_dims == 1
+      >::type
+    > : public detail::remote_common<real_t, halo, dir, n_dims>
+    {
+      using parent_t = detail::remote_common<real_t, halo, dir, n_dims>;
+      using arr_t = blitz::Array<real_t, 1>;
+      using parent_t::parent_t; // inheriting ctor
+
+      public:
+
+      void fill_halos_sclr(arr_t &a, const bool deriv = false)
+      {
+        this->xchng(a, idx_t<1>(this->intr_sclr()), idx_t<1>(this->halo_sclr()));
+      }
+
+      void fill_halos_vctr_alng(arrvec_t<arr_t> &av, const bool ad = false)
+      {
+        this->xchng(av[0], idx_t<1>(this->intr_vctr()), idx_t<1>(this->halo_vctr()));
+      }
+
+      void fill_halos_vctr_alng_cyclic(arrvec_t<arr_t> &av, const bool ad = false)
+      {
+        fill_halos_vctr_alng(av, ad);
+      }
+    };
+  } // namespace bcond
+} // namespace libmpdataxx
@@ -0,0 +1,81 @@
+// 3D remote (MPI) boundary conditions for libmpdata++
+//
+// licensing: GPU GPL v3
+// copyright: University of Warsaw
+
+#pragma once
+
+#include <libmpdata++/bcond/detail/remote_common.hpp>
+
+namespace libmpdataxx
+{
+  namespace bcond
+  {
+    template <typename real_t, int halo, bcond_e knd, drctn_e dir, int n_dims, int d>
+    class bcond<       real_t,     halo,         knd,         dir,     n_dims,     d,
+      typename std::enable_if<
+        knd == remote &&
+        n_dims == 3
+      >::type
+    > : public detail::remote_common<real_t, halo, dir, n_dims>
+    {
+      using parent_t = detail::remote_common<real_t, halo, dir, n_dims>;
+      using arr_t = blitz::Array<real_t, 3>;
+      using parent_t::parent_t; // inheriting ctor
+
+      public:
+
+      void fill_halos_sclr(arr_t &a, const rng_t &j, const rng_t &k, const bool deriv = false)
+      {
+	using namespace idxperm;
+        this->xchng(a, pi<d>(this->intr_sclr(), j, k), pi<d>(this->halo_sclr(), j, k));
+      }
+
+      void fill_halos_pres(arr_t &a, const rng_t &j, const rng_t &k)
+      {
+        fill_halos_sclr(a, j, k);
+      }
+
+      void save_edge_vel(const arr_t &, const rng_t &, const rng_t &) {}
+
+      void set_edge_pres(arr_t &, const rng_t &, const rng_t &, int) {}
+
+      void fill_halos_vctr_alng(arrvec_t<arr_t> &av, const rng_t &j, const rng_t &k, const bool ad = false)
+      {
+	using namespace idxperm;
+        this->xchng(av[d], pi<d>(this->intr_vctr(), j, k), pi<d>(this->halo_vctr(), j, k));
+      }
+
+      void fill_halos_sgs_div(arr_t &a, const rng_t &j, const rng_t &k)
+      {
+        fill_halos_sclr(a, j, k);
+      }
+
+      void fill_halos_sgs_vctr(arrvec_t<arr_t> &av, const arr_t &, const rng_t &j, const rng_t &k, const int offset = 0)
+      {
+	using namespace idxperm;
+        this->xchng(av[d + offset], pi<d>(this->intr_vctr(), j, k), pi<d>(this->halo_vctr(), j, k));
+      }
+
+      void fill_halos_sgs_tnsr(arrvec_t<arr_t> &av, const arr_t &, const arr_t &, const rng_t &j, const rng_t &k, const real_t)
+      {
+        fill_halos_vctr_alng(av, j, k);
+      }
+
+      void fill_halos_vctr_nrml(arr_t &a, const rng_t &j, const rng_t &k)
+      {
+        fill_halos_sclr(a, j, k);
+      }
+
+      void fill_halos_vctr_alng_cyclic(arrvec_t<arr_t> &av, const rng_t &j, const rng_t &k, const bool ad = false)
+      {
+        fill_halos_vctr_alng(av, j, k, ad);
+      }
+
+      void fill_halos_vctr_nrml_cyclic(arr_t &a, const rng_t &j, const rng_t &k)
+      {
+        fill_halos_vctr_nrml(a, j, k);
+      }
+    };
+  } // namespace bcond
+} // namespace libmpdataxx
@@ -55,6 +55,11 @@ namespace libmpdataxx
         a(pi<d>(this->left_edge_sclr, j)) = 0;
       }
 
+      bool mirror_pres() const
+      {
+        return true;
+      }
+
       void fill_halos_vctr_alng(arrvec_t<arr_t> &av, const rng_t &j, const bool ad = false)
       {
 	using namespace idxperm;
@@ -76,6 +81,11 @@ namespace libmpdataxx
         using namespace idxperm;
 	av[d](pi<d>(this->left_halo_vctr.last(), j)) = -av[d](pi<d>(this->left_edge_sclr + h, j));
       }
+
+      bool mirror_flux() const
+      {
+        return true;
+      }
     };
 
     template <typename real_t, int halo, bcond_e knd, drctn_e dir, int n_dims, int d>
@@ -122,6 +132,11 @@ namespace libmpdataxx
         a(pi<d>(this->rght_edge_sclr, j)) = 0;
       }
 
+      bool mirror_pres() const
+      {
+        return true;
+      }
+
       void fill_halos_vctr_alng(arrvec_t<arr_t> &av, const rng_t &j, const bool ad = false)
       {
 	using namespace idxperm;
@@ -144,6 +159,11 @@ namespace libmpdataxx
         // zero flux condition
 	av[d](pi<d>(this->rght_halo_vctr.first(), j)) = -av[d](pi<d>(this->rght_edge_sclr - h, j));
       }
+
+      bool mirror_flux() const
+      {
+        return true;
+      }
     };
   } // namespace bcond
 } // namespace libmpdataxx
@@ -55,6 +55,11 @@ namespace libmpdataxx
         a(pi<d>(this->left_edge_sclr, j, k)) = 0;
       }
 
+      bool mirror_pres() const
+      {
+        return true;
+      }
+
       void fill_halos_vctr_alng(arrvec_t<arr_t> &av, const rng_t &j, const rng_t &k, const bool ad = false)
       {
 	using namespace idxperm;
@@ -77,6 +82,11 @@ namespace libmpdataxx
         // zero flux condition
 	av[d](pi<d>(this->left_halo_vctr.last(), j, k)) = -av[d](pi<d>(this->left_edge_sclr + h, j, k));
       }
+
+      bool mirror_flux() const
+      {
+        return true;
+      }
     };
 
     template <typename real_t, int halo, bcond_e knd, drctn_e dir, int n_dims, int d>
@@ -124,6 +134,11 @@ namespace libmpdataxx
         a(pi<d>(this->rght_edge_sclr, j, k)) = 0;
       }
 
+      bool mirror_pres() const
+      {
+        return true;
+      }
+
       void fill_halos_vctr_alng(arrvec_t<arr_t> &av, const rng_t &j, const rng_t &k, const bool ad = false)
       {
 	using namespace idxperm;
@@ -146,6 +161,11 @@ namespace libmpdataxx
         // zero flux condition
 	av[d](pi<d>(this->rght_halo_vctr.first(), j, k)) = -av[d](pi<d>(this->rght_edge_sclr - h, j, k));
       }
+
+      bool mirror_flux() const
+      {
+        return true;
+      }
     };
   } // namespace bcond
 } // namespace libmpdataxx
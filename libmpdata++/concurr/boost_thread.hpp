@@ -7,6 +7,7 @@
 #pragma once
 
 #include <libmpdata++/concurr/detail/concurr_common.hpp>
+#include <libmpdata++/concurr/detail/thread_pool.hpp>
 
 #include <boost/thread.hpp>
 
@@ -40,9 +41,9 @@ namespace libmpdataxx
 	{
 	  const char *env_var("OMP_NUM_THREADS");
 
-          int nthreads = std::min((std::getenv(env_var) != NULL) ?
+          int nthreads = std::min<unsigned>((std::getenv(env_var) != NULL) ?
                                     std::atoi(std::getenv(env_var)) // TODO: check if conversion OK?
-	                          : boost::thread::hardware_concurrency()
+	                          : detail::placement().n_threads() // affinity mask and cgroup quota aware
                                   ,
                                   max_threads);
 
@@ -51,9 +52,13 @@ namespace libmpdataxx
 
 
         // ctor
-        mem_t(const std::array<int, solver_t::n_dims> &grid_size) :
-          b(size(grid_size[0])),
-          parent_t::mem_t(grid_size, size(grid_size[0])) 
+        mem_t(
+          const std::array<int, solver_t::n_dims> &grid_size,
+          const std::array<int, solver_t::n_dims> &decomp,
+          const bool &hybrid
+        ) :
+          b(size(parent_t::mem_t::max_size(grid_size, decomp))),
+          parent_t::mem_t(grid_size, size(parent_t::mem_t::max_size(grid_size, decomp)), decomp, hybrid) 
         {}; 
 
 	void barrier()
@@ -63,25 +68,27 @@ namespace libmpdataxx
 	}
       };
 
+      std::unique_ptr<detail::thread_pool<boost::thread>> workers;
+
       public:
 
       void solve(typename parent_t::advance_arg_t nt)
       {
-        boost::thread_group threads;
-        for (int i = 0; i < this->algos.size(); ++i) 
-        {  
-          std::unique_ptr<boost::thread> thp;
-          thp.reset(new boost::thread(
-            &solver_t::solve, boost::ref(this->algos[i]), nt
-          ));
-          threads.add_thread(thp.release());
-        }
-        threads.join_all();
+        if (!workers) throw std::runtime_error("advance() called on an instance constructed with ext_workers_t, use ext_solve()");
+        workers->run([&](const int rank) { this->algos[rank].solve(nt); });
       }
 
       // ctor
       boost_thread(const typename solver_t::rt_params_t &p) : 
-        parent_t(p, new mem_t(p.grid_size), mem_t::size(p.grid_size[0]))
+        parent_t(p, new mem_t(p.grid_size, p.decomp, p.hybrid)),
+        workers(new detail::thread_pool<boost::thread>(this->algos.size()))
+      {
+        workers->run([&](const int rank) { this->thread_init(rank, p); });
+      }
+
+      // ctor with no threads of its own (see ext_init() and ext_solve())
+      boost_thread(const typename solver_t::rt_params_t &p, detail::ext_workers_t) : 
+        parent_t(p, new mem_t(p.grid_size, p.decomp, p.hybrid))
       {}
 
     };
@@ -7,58 +7,18 @@
 #pragma once
 
 #include <libmpdata++/concurr/detail/concurr_common.hpp>
+#include <libmpdata++/concurr/detail/thread_pool.hpp>
+#include <libmpdata++/concurr/detail/barrier.hpp>
 
 #include <thread>
-#include <mutex>
-#include <condition_variable>
 #include <limits>
 
-#include <boost/ptr_container/ptr_vector.hpp>
-
 #include <cstdlib> // std::getenv()
 
 namespace libmpdataxx
 {
   namespace concurr
   {
-    namespace detail
-    {
-      // based on boost barrier's code
-      class barrier
-      {
-	std::mutex m_mutex;
-	std::condition_variable m_cond;
-	std::size_t m_generation, m_count;
-        const std::size_t m_threshold;
-
-	public:
-
-	explicit barrier(const std::size_t count) : 
-          m_count(count), 
-          m_threshold(count),
-          m_generation(0) 
-        { }
-
-	bool wait()
-	{
-          std::unique_lock<std::mutex> lock(m_mutex);
-          unsigned int gen = m_generation;
-
-          if (--m_count == 0)
-          {
-            m_generation++;
-            m_count = m_threshold;
-            m_cond.notify_all();
-            return true;
-          }
-
-          while (gen == m_generation)
-            m_cond.wait(lock);
-          return false;
-	}
-      };
-    };
-
     template <
       class solver_t,
       bcond::bcond_e bcxl,
@@ -82,9 +42,9 @@ namespace libmpdataxx
 	{
 	  const char *env_var("OMP_NUM_THREADS");
 
-          int nthreads = std::min((std::getenv(env_var) != NULL) ?
+          int nthreads = std::min<unsigned>((std::getenv(env_var) != NULL) ?
                                     std::atoi(std::getenv(env_var)) // TODO: check if conversion OK?
-	                          : std::thread::hardware_concurrency()
+	                          : detail::placement().n_threads() // affinity mask and cgroup quota aware
                                   ,
                                   max_threads);
 
@@ -92,9 +52,13 @@ namespace libmpdataxx
 	}
 
         // ctor
-        mem_t(const std::array<int, solver_t::n_dims> &grid_size) :
-          b(size(grid_size[0])),
-          parent_t::mem_t(grid_size, size(grid_size[0])) 
+        mem_t(
+          const std::array<int, solver_t::n_dims> &grid_size,
+          const std::array<int, solver_t::n_dims> &decomp,
+          const bool &hybrid
+        ) :
+          b(size(parent_t::mem_t::max_size(grid_size, decomp))),
+          parent_t::mem_t(grid_size, size(parent_t::mem_t::max_size(grid_size, decomp)), decomp, hybrid) 
         {}; 
 
 	void barrier()
@@ -103,23 +67,27 @@ namespace libmpdataxx
 	}
       };
 
+      std::unique_ptr<detail::thread_pool<std::thread>> workers;
+
       public:
 
       void solve(typename parent_t::advance_arg_t nt)
       {
-        boost::ptr_vector<std::thread> threads(mem_t::size());
-        for (int i = 0; i < this->algos.size(); ++i) 
-        {  
-          threads.push_back(new std::thread(
-            &solver_t::solve, &(this->algos[i]), nt
-          ));
-        }
-        for (auto &th : threads) th.join();
+        if (!workers) throw std::runtime_error("advance() called on an instance constructed with ext_workers_t, use ext_solve()");
+        workers->run([&](const int rank) { this->algos[rank].solve(nt); });
       }
 
       // ctor
       cxx11_thread(const typename solver_t::rt_params_t &p) : 
-        parent_t(p, new mem_t(p.grid_size), mem_t::size(p.grid_size[0]))
+        parent_t(p, new mem_t(p.grid_size, p.decomp, p.hybrid)),
+        workers(new detail::thread_pool<std::thread>(this->algos.size()))
+      {
+        workers->run([&](const int rank) { this->thread_init(rank, p); });
+      }
+
+      // ctor with no threads of its own (see ext_init() and ext_solve())
+      cxx11_thread(const typename solver_t::rt_params_t &p, detail::ext_workers_t) : 
+        parent_t(p, new mem_t(p.grid_size, p.decomp, p.hybrid))
       {}
 
     };
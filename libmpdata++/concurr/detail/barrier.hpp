@@ -0,0 +1,104 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ */
+
+#pragma once
+
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <thread>
+#include <cstdlib> // std::getenv()
+
+// default number of busy-wait iterations before a thread waiting
+// at a barrier falls back to sleeping on the condition variable
+// (0 means the barrier always blocks right away);
+// can be overridden at run time with the LIBMPDATAXX_BARRIER_SPIN env. variable
+#if !defined(LIBMPDATAXX_BARRIER_SPIN)
+#  define LIBMPDATAXX_BARRIER_SPIN 0
+#endif
+
+namespace libmpdataxx
+{
+  namespace concurr
+  {
+    namespace detail
+    {
+      inline void cpu_relax()
+      {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#else
+        std::this_thread::yield();
+#endif
+      }
+
+      // based on boost barrier's code, extended with a sense-reversing
+      // fast path: the generation counter acts as the sense flag and
+      // waiting threads first spin on it for a bounded number of
+      // iterations, and only then block on the condition variable
+      // (with spin == 0 it behaves as the original blocking barrier)
+      class barrier
+      {
+	std::mutex m_mutex;
+	std::condition_variable m_cond;
+	std::atomic<std::size_t> m_generation, m_count;
+        const std::size_t m_threshold;
+        const unsigned long m_spin;
+
+	public:
+
+        static unsigned long spin_default()
+        {
+	  const char *env_var("LIBMPDATAXX_BARRIER_SPIN");
+          return (std::getenv(env_var) != NULL)
+            ? std::strtoul(std::getenv(env_var), NULL, 10)
+            : LIBMPDATAXX_BARRIER_SPIN;
+        }
+
+	explicit barrier(
+          const std::size_t count,
+          const unsigned long spin = spin_default()
+        ) :
+          m_generation(0),
+          m_count(count),
+          m_threshold(count),
+          // spinning only pays off if each thread has a core of its own
+          m_spin(count <= std::thread::hardware_concurrency() ? spin : 0)
+        { }
+
+	bool wait()
+	{
+          const std::size_t gen = m_generation.load(std::memory_order_acquire);
+
+          if (m_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+          {
+            // no other thread can arrive before the generation changes
+            m_count.store(m_threshold, std::memory_order_relaxed);
+            {
+              std::lock_guard<std::mutex> lock(m_mutex);
+              m_generation.fetch_add(1, std::memory_order_release);
+            }
+            m_cond.notify_all();
+            return true;
+          }
+
+          for (unsigned long i = 0; i < m_spin; ++i)
+          {
+            if (m_generation.load(std::memory_order_acquire) != gen) return false;
+            // letting other threads run in case the cores are oversubscribed
+            if ((i + 1) % 64 == 0) std::this_thread::yield(); else cpu_relax();
+          }
+
+          std::unique_lock<std::mutex> lock(m_mutex);
+          while (m_generation.load(std::memory_order_acquire) == gen)
+            m_cond.wait(lock);
+          return false;
+	}
+      };
+    } // namespace detail
+  } // namespace concurr
+} // namespace libmpdataxx
@@ -26,9 +26,13 @@
 #include <libmpdata++/bcond/rigid_2d.hpp>
 #include <libmpdata++/bcond/rigid_3d.hpp>
 #include <libmpdata++/bcond/gndsky_3d.hpp>
+#include <libmpdata++/bcond/remote_1d.hpp>
+#include <libmpdata++/bcond/remote_2d.hpp>
+#include <libmpdata++/bcond/remote_3d.hpp>
 
 #include <libmpdata++/concurr/detail/sharedmem.hpp>
 #include <libmpdata++/concurr/detail/timer.hpp>
+#include <libmpdata++/concurr/detail/placement.hpp>
 #include <libmpdata++/concurr/any.hpp>
 
 namespace libmpdataxx
@@ -37,6 +41,10 @@ namespace libmpdataxx
   {
     namespace detail
     {
+      // ctor tag of the threaded backends: no threads of their own, the ranks are to be run
+      // by the caller through ext_init() and ext_solve() (see concurr::ensemble)
+      struct ext_workers_t {};
+
       template<
         class solver_t_, 
         bcond::bcond_e bcxl, bcond::bcond_e bcxr,
@@ -78,6 +86,15 @@ namespace libmpdataxx
 	boost::ptr_vector<solver_t> algos; 
         std::unique_ptr<mem_t> mem;
         timer tmr;
+        std::vector<int> pin_map; // CPU for each rank (empty if not pinning)
+        bool verbose; // see rt_params_t::verbose
+
+        // to be called by the backends from the thread running a given rank, before the first solve()
+        void thread_init(const int &rank, const typename solver_t::rt_params_t &p)
+        {
+          if (!pin_map.empty()) placement::pin(pin_map[rank]);
+          if (p.numa_plc == first_touch || (p.hybrid && p.numa_plc == default_plc)) algos[rank].touch_subdomain();
+        }
 
 	public:
 
@@ -88,31 +105,186 @@ namespace libmpdataxx
 	virtual ~concurr_common()
         {
           tmr.print();
+          if (verbose) print_xchng_stats();
+          if (verbose && mem->rebalance_every > 0) print_rebalance_stats();
         }
 
 	// ctor
 	concurr_common(
 	  const typename solver_t::rt_params_t &p,
-          mem_t *mem_p,
-	  const int &size
-	) {
+          mem_t *mem_p
+	) :
+          verbose(p.verbose)
+        {
           // allocate the memory to be shared by multiple threads
           mem.reset(mem_p);
 	  solver_t::alloc(mem.get(), p.n_iters);
+          alloc_bcond(p);
+
+          // sanity check for the process grid
+          check_decomp(); 
+
+          // sanity checks for multiple MPI processes
+          if (mem->distmem.size() > 1) check_distmem();
+
+          // neighbour-only synchronisation of halo exchanges
+          if (p.nghbr_sync) 
+          {
+            check_nghbr_sync();
+            mem->nghbr_sync = true;
+          }
+
+          // skipping exchanges of advectees with valid halos (opt-in, see rt_params_t::halo_track)
+          mem->halo_track = p.halo_track;
+
+          // dynamic load balancing (nothing to balance with a single slab)
+          if (p.rebalance_every > 0 && mem->decomp[0] > 1) mem->rebalance_every = p.rebalance_every;
 
           // allocate per-thread structures
-          init(p, mem->grid_size, size); 
+          init(p, mem->grid_size, mem->decomp); 
+
+          // NUMA placement hint (first touch is done by the backends once the threads are up)
+          if (p.numa_plc == interleave) mem->interleave_pages();
+
+          // thread pinning (done by the backends through thread_init()), 
+          // with the hybrid decomposition keeping the threads of a slab within a package
+          const pin_plc_t pin_plc = p.hybrid && p.pin_plc == no_pinning ? package_pinning : p.pin_plc;
+          if (pin_plc != no_pinning)
+          {
+            placement plc;
+            pin_map = plc.map(mem->size, pin_plc);
+            if (verbose) std::cerr << plc.report(pin_map) << std::endl;
+          }
         }
 
         private:
+
+        // the cyclic domain edges (with multiple MPI processes the edges along the first dimension
+        // are handled by remote bconds) passed on to the solver allocation depending on them
+        void alloc_bcond(const typename solver_t::rt_params_t &p)
+        {
+          const bcond::bcond_e bcs[3][2] = {{bcxl, bcxr}, {bcyl, bcyr}, {bczl, bczr}};
+          std::array<std::array<bool, 2>, solver_t::n_dims> cyclic;
+          for (int d = 0; d < solver_t::n_dims; ++d)
+            for (int s = 0; s < 2; ++s)
+              cyclic[d][s] = bcs[d][s] == bcond::cyclic && !(d == 0 && mem->distmem.size() > 1);
+          solver_t::alloc_bcond(mem.get(), p, cyclic);
+        }
+
+        // open bconds zero the tangential advector components at the domain edges 
+        // in all higher dimensions, and hence need the whole domain span there
+        void check_decomp()
+        {
+          const bcond::bcond_e bcs[3][2] = {{bcxl, bcxr}, {bcyl, bcyr}, {bczl, bczr}};
+          for (int d = 0; d < solver_t::n_dims; ++d)
+            for (int dd = d + 1; dd < solver_t::n_dims; ++dd)
+              if (mem->decomp[dd] > 1 && (bcs[d][0] == bcond::open || bcs[d][1] == bcond::open))
+                throw std::runtime_error("open boundary conditions not supported with domain decomposition in higher dimensions");
+        }
  
+        // each process exchanges halos with its neighbours along the first dimension 
+        // with one message per thread subdomain along the process edge
+        void check_distmem()
+        {
+          const bcond::bcond_e bcs[3][2] = {{bcxl, bcxr}, {bcyl, bcyr}, {bczl, bczr}};
+          if (mem->size > 1 && !mem->distmem.thread_safe())
+            throw std::runtime_error("multiple threads per MPI process require MPI_THREAD_MULTIPLE support");
+          if (mem->grid_size[0].length() < solver_t::halo)
+            throw std::runtime_error("MPI process subdomains narrower than the halo");
+          for (int d = 0; d < solver_t::n_dims; ++d)
+          {
+            if (bcs[d][0] == bcond::polar || bcs[d][1] == bcond::polar)
+              throw std::runtime_error("polar boundary conditions not supported with multiple MPI processes");
+            if (d > 0 && !mem->distmem.uniform(mem->decomp[d]))
+              throw std::runtime_error("thread domain decomposition differs between MPI processes, please set rt_params_t::decomp");
+          }
+        }
+
+        // halo exchange statistics summed over subdomains
+        void print_xchng_stats()
+        {
+          typename mem_t::xchng_stats_t sum;
+          for (const auto &st : mem->xchng_stats)
+          {
+            sum.done += st.done;
+            sum.skipped += st.skipped;
+            sum.barriers_saved += st.barriers_saved;
+          }
+          std::cerr 
+            << " halo exchanges: " << sum.done << " done,"
+            << " " << sum.skipped << " skipped,"
+            << " barriers saved: " << sum.barriers_saved 
+            << std::endl;
+        }
+
+        // number of slab boundary moves and the resultant slab widths
+        void print_rebalance_stats()
+        {
+          const auto &bnds = mem->slab_bounds();
+          std::cerr << " slab rebalancing: " << mem->rebalance_cnt << " times, slab widths:";
+          for (std::size_t i0 = 0; i0 + 1 < bnds.size(); ++i0) std::cerr << " " << bnds[i0 + 1] - bnds[i0];
+          std::cerr << std::endl;
+        }
+
+        // neighbour-only synchronisation assumes that halos are filled with data 
+        // from adjacent subdomains only
+        void check_nghbr_sync()
+        {
+          const bcond::bcond_e bcs[3][2] = {{bcxl, bcxr}, {bcyl, bcyr}, {bczl, bczr}};
+          for (int d = 0; d < solver_t::n_dims; ++d)
+          {
+            if (bcs[d][0] == bcond::polar || bcs[d][1] == bcond::polar)
+              throw std::runtime_error("neighbour-only synchronisation not supported with polar boundary conditions");
+            if (mem->decomp[d] > 1 && (mem->grid_size[d].length() / mem->decomp[d]) < solver_t::halo)
+              throw std::runtime_error("neighbour-only synchronisation requires subdomains not narrower than the halo");
+          }
+        }
+
+        // domain-edge subdomains get the requested bconds, 
+        // the others exchange halos through shared memory,
+        // or through MPI at edges of the part of the domain owned by the process
         template <
           bcond::bcond_e type,
           bcond::drctn_e dir,
           int dim
         >
-        void bc_set(typename solver_t::bcp_t &bcp) 
-        {
+        void bc_set(
+          typename solver_t::bcp_t &bcp,
+          const int &rank = 0,
+          const int &size = 1,
+          const int &tag = 0 // index of the subdomain in other dimensions
+        ) {
+          if (
+            (dir == bcond::left && rank != 0) ||
+            (dir == bcond::rght && rank != size - 1)
+          ) 
+          {
+            bcp.reset(new bcond::shared<real_t, solver_t::halo>());
+            return;
+          }
+
+          if (dim == 0 && mem->distmem.size() > 1)
+          {
+            const int mpi_rank = mem->distmem.rank(), mpi_size = mem->distmem.size();
+            if (
+              (dir == bcond::left && (mpi_rank != 0 || type == bcond::cyclic)) ||
+              (dir == bcond::rght && (mpi_rank != mpi_size - 1 || type == bcond::cyclic))
+            )
+            {
+              bcp.reset(
+                new bcond::bcond<real_t, solver_t::halo, bcond::remote, dir, solver_t::n_dims, dim>(
+                  mem->slab(mem->grid_size[dim]), 
+                  mem->grid_size[0].length(),
+                  mem->distmem,
+                  (mpi_rank + (dir == bcond::left ? -1 : 1) + mpi_size) % mpi_size,
+                  tag,
+                  (dir == bcond::left && mpi_rank == 0) || (dir == bcond::rght && mpi_rank == mpi_size - 1)
+                )
+              );
+              return;
+            }
+          }
+
 	  bcp.reset(
             new bcond::bcond<real_t, solver_t::halo, type, dir, solver_t::n_dims, dim>(
 	      mem->slab(mem->grid_size[dim]), 
@@ -124,26 +296,26 @@ namespace libmpdataxx
         // 1D version
         void init(
           const typename solver_t::rt_params_t &p,
-          const std::array<rng_t, 1> &grid_size, const int &n0
+          const std::array<rng_t, 1> &grid_size, 
+          const std::array<int, 1> &decomp
         )
         {
-          typename solver_t::bcp_t bxl, bxr, shrdl, shrdr;
-
-          bc_set<bcxl, bcond::left, 0>(bxl);
-	  bc_set<bcxr, bcond::rght, 0>(bxr);
+          const int n0 = decomp[0];
 
 	  for (int i0 = 0; i0 < n0; ++i0) 
           {
-            shrdl.reset(new bcond::shared<real_t, solver_t::halo>());
-            shrdr.reset(new bcond::shared<real_t, solver_t::halo>());
+            typename solver_t::bcp_t bxl, bxr;
+
+            bc_set<bcxl, bcond::left, 0>(bxl, i0, n0);
+            bc_set<bcxr, bcond::rght, 0>(bxr, i0, n0);
 
 	    algos.push_back(
               new solver_t(
                 typename solver_t::ctor_args_t({
                   i0,
 		  mem.get(), 
-		  i0 == 0      ? bxl : shrdl,
-		  i0 == n0 - 1 ? bxr : shrdr,
+		  bxl,
+		  bxr,
 		  mem->slab(grid_size[0], i0, n0)
                 }), 
                 p
@@ -157,30 +329,28 @@ namespace libmpdataxx
         void init(
           const typename solver_t::rt_params_t &p,
 	  const std::array<rng_t, 2> &grid_size, 
-          const int &n0, const int &n1 = 1
+          const std::array<int, 2> &decomp
         ) {
+          const int n0 = decomp[0], n1 = decomp[1];
+
           for (int i0 = 0; i0 < n0; ++i0) 
           {
             for (int i1 = 0; i1 < n1; ++i1) 
             {
-	      typename solver_t::bcp_t bxl, bxr, byl, byr, shrdl, shrdr;
+	      typename solver_t::bcp_t bxl, bxr, byl, byr;
 
-              bc_set<bcxl, bcond::left, 0>(bxl);
-	      bc_set<bcxr, bcond::rght, 0>(bxr);
+              bc_set<bcxl, bcond::left, 0>(bxl, i0, n0, i1);
+	      bc_set<bcxr, bcond::rght, 0>(bxr, i0, n0, i1);
 
-              bc_set<bcyl, bcond::left, 1>(byl);
-	      bc_set<bcyr, bcond::rght, 1>(byr);
-
-              shrdl.reset(new bcond::shared<real_t, solver_t::halo>()); // TODO: shrdy if n1 != 1
-              shrdr.reset(new bcond::shared<real_t, solver_t::halo>()); // TODO: shrdy if n1 != 1
+              bc_set<bcyl, bcond::left, 1>(byl, i1, n1);
+	      bc_set<bcyr, bcond::rght, 1>(byr, i1, n1);
 
               algos.push_back(
                 new solver_t(
                   typename solver_t::ctor_args_t({
-                    i0,
+                    i0 * n1 + i1,
 		    mem.get(), 
-		    i0 == 0      ? bxl : shrdl,
-		    i0 == n0 - 1 ? bxr : shrdr,
+		    bxl, bxr,
 		    byl, byr, 
 		    mem->slab(grid_size[0], i0, n0),  
                     mem->slab(grid_size[1], i1, n1)
@@ -196,36 +366,33 @@ namespace libmpdataxx
         void init(
           const typename solver_t::rt_params_t &p,
 	  const std::array<rng_t, 3> &grid_size, 
-          const int &n0, const int &n1 = 1, const int &n2 = 1
+          const std::array<int, 3> &decomp
         ) {
-          typename solver_t::bcp_t bxl, bxr, byl, byr, bzl, bzr, shrdl, shrdr;
+          const int n0 = decomp[0], n1 = decomp[1], n2 = decomp[2];
 
-	  // TODO: renew pointers only if invalid ?
 	  for (int i0 = 0; i0 < n0; ++i0) 
           {
 	    for (int i1 = 0; i1 < n1; ++i1) 
             {
 	      for (int i2 = 0; i2 < n2; ++i2) 
               {
-                bc_set<bcxl, bcond::left, 0>(bxl);
-                bc_set<bcxr, bcond::rght, 0>(bxr);
+                typename solver_t::bcp_t bxl, bxr, byl, byr, bzl, bzr;
 
-                bc_set<bcyl, bcond::left, 1>(byl);
-                bc_set<bcyr, bcond::rght, 1>(byr);
+                bc_set<bcxl, bcond::left, 0>(bxl, i0, n0, i1 * n2 + i2);
+                bc_set<bcxr, bcond::rght, 0>(bxr, i0, n0, i1 * n2 + i2);
 
-                bc_set<bczl, bcond::left, 2>(bzl);
-                bc_set<bczr, bcond::rght, 2>(bzr);
+                bc_set<bcyl, bcond::left, 1>(byl, i1, n1);
+                bc_set<bcyr, bcond::rght, 1>(byr, i1, n1);
 
-                shrdl.reset(new bcond::shared<real_t, solver_t::halo>()); // TODO: shrdy if n1 != 1
-                shrdr.reset(new bcond::shared<real_t, solver_t::halo>()); // TODO: shrdy if n1 != 1
+                bc_set<bczl, bcond::left, 2>(bzl, i2, n2);
+                bc_set<bczr, bcond::rght, 2>(bzr, i2, n2);
 
 		algos.push_back(
                   new solver_t(
                     typename solver_t::ctor_args_t({
-                      i0,
+                      (i0 * n1 + i1) * n2 + i2,
                       mem.get(), 
-		      i0 == 0      ? bxl : shrdl,
-		      i0 == n0 - 1 ? bxr : shrdr,
+		      bxl, bxr,
                       byl, byr, 
                       bzl, bzr, 
                       mem->slab(grid_size[0], i0, n0), 
@@ -290,6 +457,27 @@ namespace libmpdataxx
         {
           return algos[0].time_();
         }
+
+        // number of threads (i.e. of subdomains)
+        int n_threads() const
+        {
+          return mem->size;
+        }
+
+        // for drivers running the ranks on threads of their own (backends constructed with ext_workers_t):
+        // thread_init() without pinning (the caller's threads are not bound to this instance) ...
+        void ext_init(const int rank, const typename solver_t::rt_params_t &p)
+        {
+          if (p.numa_plc == first_touch || (p.hybrid && p.numa_plc == default_plc)) algos[rank].touch_subdomain();
+        }
+
+        // ... and solve(), both to be called concurrently for all ranks from n_threads() distinct threads
+        void ext_solve(const int rank, advance_arg_t nt)
+        {
+          if (rank == 0) tmr.resume();
+          algos[rank].solve(nt);
+          if (rank == 0) tmr.stop();
+        }
       };
     } // namespace detail
   } // namespace concurr
@@ -0,0 +1,138 @@
+/** @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ */
+
+#pragma once
+
+#include <vector>
+#include <functional>
+#include <algorithm>
+
+#if defined(USE_MPI)
+#  include <boost/mpi/environment.hpp>
+#  include <boost/mpi/communicator.hpp>
+#  include <boost/mpi/collectives.hpp>
+#  include <boost/mpi/operations.hpp>
+#endif
+
+namespace libmpdataxx
+{
+  namespace concurr
+  {
+    namespace detail
+    {
+      // distributed-memory part of the concurrency layer: each MPI process owns
+      // a slab of the domain along the first dimension (which may then be further
+      // divided among threads by sharedmem); without USE_MPI a single-process stub
+      class distmem
+      {
+#if defined(USE_MPI)
+        // initialising MPI unless done by the user (finalised at program exit)
+        static bool init()
+        {
+          if (!boost::mpi::environment::initialized())
+          {
+            static boost::mpi::environment env(boost::mpi::threading::multiple);
+          }
+          return true;
+        }
+        const bool initialised = init(); // (needs to precede mpicom)
+
+        boost::mpi::communicator mpicom; // MPI_COMM_WORLD
+#endif
+
+        public:
+
+        int rank() const
+        {
+#if defined(USE_MPI)
+          return mpicom.rank();
+#else
+          return 0;
+#endif
+        }
+
+        int size() const
+        {
+#if defined(USE_MPI)
+          return mpicom.size();
+#else
+          return 1;
+#endif
+        }
+
+        /// @brief true if MPI calls may be issued concurrently from multiple threads
+        bool thread_safe() const
+        {
+#if defined(USE_MPI)
+          return boost::mpi::environment::thread_level() == boost::mpi::threading::multiple;
+#else
+          return true;
+#endif
+        }
+
+#if defined(USE_MPI)
+        const boost::mpi::communicator &comm() const
+        {
+          return mpicom;
+        }
+#endif
+
+        void barrier()
+        {
+#if defined(USE_MPI)
+          mpicom.barrier();
+#endif
+        }
+
+        // reductions across processes (to be called by one thread per process)
+        template <typename T>
+        T sum(const T &val)
+        {
+#if defined(USE_MPI)
+          if (size() > 1) return boost::mpi::all_reduce(mpicom, val, std::plus<T>());
+#endif
+          return val;
+        }
+
+        template <typename T>
+        T min(const T &val)
+        {
+#if defined(USE_MPI)
+          if (size() > 1) return boost::mpi::all_reduce(mpicom, val, boost::mpi::minimum<T>());
+#endif
+          return val;
+        }
+
+        template <typename T>
+        T max(const T &val)
+        {
+#if defined(USE_MPI)
+          if (size() > 1) return boost::mpi::all_reduce(mpicom, val, boost::mpi::maximum<T>());
+#endif
+          return val;
+        }
+
+        // element-wise sum of several values within a single call
+        template <typename T>
+        void sum(std::vector<T> &vals)
+        {
+#if defined(USE_MPI)
+          if (size() == 1 || vals.empty()) return;
+          std::vector<T> in(vals);
+          boost::mpi::all_reduce(mpicom, in.data(), in.size(), vals.data(), std::plus<T>());
+#endif
+        }
+
+        /// @brief true if a value is the same on all processes
+        template <typename T>
+        bool uniform(const T &val)
+        {
+          return min(val) == max(val);
+        }
+      };
+    } // namespace detail
+  } // namespace concurr
+} // namespace libmpdataxx
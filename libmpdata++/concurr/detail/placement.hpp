@@ -0,0 +1,197 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ */
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <algorithm>
+#include <thread>
+#include <cmath>
+#include <tuple>
+
+#if defined(__linux__)
+#  include <sched.h>
+#endif
+
+namespace libmpdataxx
+{
+  namespace concurr
+  {
+    // pinning of the threads running the subdomains to CPUs
+    enum pin_plc_t
+    {
+      no_pinning,      // left to the OS scheduler
+      compact_pinning, // consecutive subdomains on consecutive cores, filling one socket after another
+      scatter_pinning, // consecutive subdomains distributed round-robin across sockets
+      package_pinning  // consecutive subdomains filling all CPUs (incl. hardware threads) of one socket after another
+    };
+
+    namespace detail
+    {
+      // CPU topology as seen by the process (Linux: sched_getaffinity(), /sys and cgroup quotas),
+      // elsewhere falling back to hardware_concurrency() and no pinning
+      class placement
+      {
+        struct cpu_t
+        {
+          int id, package, core, smt; // smt: index among hardware threads of the same core
+        };
+
+        std::vector<cpu_t> cpus; // CPUs the process is allowed to run on
+        int quota = 0;           // CPU limit from cgroup quota (0 if none)
+
+        template <typename T>
+        static bool read(const std::string &path, T &value)
+        {
+          std::ifstream is(path);
+          return bool(is >> value);
+        }
+
+        // cgroup v2 (cpu.max: "quota period" or "max period") or v1 (cfs_quota_us and cfs_period_us)
+        static int cgroup_quota()
+        {
+          std::string q;
+          double quota, period;
+          {
+            std::ifstream is("/sys/fs/cgroup/cpu.max");
+            if (is >> q >> period && q != "max" && period > 0)
+              return std::max(1, int(std::ceil(std::stod(q) / period)));
+          }
+          if (
+            read("/sys/fs/cgroup/cpu/cpu.cfs_quota_us", quota) && quota > 0 &&
+            read("/sys/fs/cgroup/cpu/cpu.cfs_period_us", period) && period > 0
+          )
+            return std::max(1, int(std::ceil(quota / period)));
+          return 0;
+        }
+
+        public:
+
+        // ctor
+        placement()
+        {
+#if defined(__linux__)
+          cpu_set_t mask;
+          CPU_ZERO(&mask);
+          if (sched_getaffinity(0, sizeof(mask), &mask) == 0)
+          {
+            for (int id = 0; id < CPU_SETSIZE; ++id)
+            {
+              if (!CPU_ISSET(id, &mask)) continue;
+              cpu_t cpu{id, 0, id, 0};
+              const std::string topo = "/sys/devices/system/cpu/cpu" + std::to_string(id) + "/topology/";
+              read(topo + "physical_package_id", cpu.package);
+              read(topo + "core_id", cpu.core);
+              cpus.push_back(cpu);
+            }
+          }
+          quota = cgroup_quota();
+
+          // numbering hardware threads of each core
+          std::sort(cpus.begin(), cpus.end(), [](const cpu_t &a, const cpu_t &b) {
+            return std::tie(a.package, a.core, a.id) < std::tie(b.package, b.core, b.id);
+          });
+          for (std::size_t c = 1; c < cpus.size(); ++c)
+            if (cpus[c].package == cpus[c-1].package && cpus[c].core == cpus[c-1].core)
+              cpus[c].smt = cpus[c-1].smt + 1;
+#endif
+        }
+
+        /// @brief default number of threads: CPUs in the affinity mask, limited by the cgroup quota
+        int n_threads() const
+        {
+          int n = cpus.empty() ? std::thread::hardware_concurrency() : cpus.size();
+          if (quota > 0) n = std::min(n, quota);
+          return std::max(1, n);
+        }
+
+        /// @brief number of CPU packages (sockets) with CPUs in the affinity mask (1 if unknown)
+        int n_packages() const
+        {
+          std::vector<int> pkgs;
+          for (const auto &cpu : cpus)
+            if (std::find(pkgs.begin(), pkgs.end(), cpu.package) == pkgs.end()) pkgs.push_back(cpu.package);
+          return std::max<int>(1, pkgs.size());
+        }
+
+        /// @brief CPUs to be used by consecutive ranks (hardware-thread siblings used only
+        ///        once all cores are taken, wrapping around if there are more ranks than CPUs);
+        ///        empty if no pinning is requested or topology is unknown
+        std::vector<int> map(const int &size, const pin_plc_t &plc) const
+        {
+          std::vector<int> ret;
+          if (plc == no_pinning || cpus.empty()) return ret;
+
+          std::vector<cpu_t> order(cpus);
+          if (plc == package_pinning)
+          {
+            std::stable_sort(order.begin(), order.end(), [](const cpu_t &a, const cpu_t &b) {
+              return std::tie(a.package, a.smt) < std::tie(b.package, b.smt);
+            });
+          }
+          else if (plc == compact_pinning)
+          {
+            std::stable_sort(order.begin(), order.end(), [](const cpu_t &a, const cpu_t &b) {
+              return std::tie(a.smt, a.package) < std::tie(b.smt, b.package);
+            });
+          }
+          else
+          {
+            // index of a core within its package
+            std::vector<int> nth(order.size(), 0);
+            for (std::size_t c = 0; c < order.size(); ++c)
+              for (std::size_t cc = 0; cc < c; ++cc)
+                if (order[cc].package == order[c].package && order[cc].smt == order[c].smt) ++nth[c];
+            std::vector<std::size_t> idx(order.size());
+            for (std::size_t c = 0; c < idx.size(); ++c) idx[c] = c;
+            std::stable_sort(idx.begin(), idx.end(), [&](const std::size_t &a, const std::size_t &b) {
+              return std::tie(order[a].smt, nth[a], order[a].package) < std::tie(order[b].smt, nth[b], order[b].package);
+            });
+            std::vector<cpu_t> tmp;
+            for (const auto &c : idx) tmp.push_back(order[c]);
+            order.swap(tmp);
+          }
+
+          for (int rank = 0; rank < size; ++rank)
+            ret.push_back(order[rank % order.size()].id);
+          return ret;
+        }
+
+        /// @brief pins the calling thread to a given CPU (returns false on failure)
+        static bool pin(const int &cpu)
+        {
+#if defined(__linux__)
+          cpu_set_t mask;
+          CPU_ZERO(&mask);
+          CPU_SET(cpu, &mask);
+          return sched_setaffinity(0, sizeof(mask), &mask) == 0;
+#else
+          return false;
+#endif
+        }
+
+        /// @brief human-readable rank-to-CPU mapping
+        std::string report(const std::vector<int> &map) const
+        {
+          std::ostringstream os;
+          os << " thread placement (" << cpus.size() << " CPUs allowed";
+          if (quota > 0) os << ", cgroup quota: " << quota;
+          os << "):";
+          for (std::size_t rank = 0; rank < map.size(); ++rank)
+          {
+            const auto cpu = std::find_if(cpus.begin(), cpus.end(), [&](const cpu_t &c) { return c.id == map[rank]; });
+            os << " " << rank << "->cpu" << cpu->id << "(pkg" << cpu->package << ",core" << cpu->core << ")";
+          }
+          return os.str();
+        }
+      };
+    } // namespace detail
+  } // namespace concurr
+} // namespace libmpdataxx
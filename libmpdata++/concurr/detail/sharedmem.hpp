@@ -7,17 +7,40 @@
 #pragma once
 
 #include <unordered_map>
+#include <algorithm>
 #include <boost/ptr_container/ptr_vector.hpp>
 
 #include <libmpdata++/blitz.hpp>
 #include <libmpdata++/formulae/arakawa_c.hpp>
+#include <libmpdata++/concurr/detail/distmem.hpp>
+#include <libmpdata++/concurr/detail/placement.hpp>
 
 #include <array>
+#include <cstdint>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <limits>
+#include <numeric>
+#include <ctime> // clock_gettime()
+
+#if defined(__linux__)
+#  include <unistd.h>
+#  include <sys/syscall.h>
+#endif
 
 namespace libmpdataxx
 {
   namespace concurr
   {
+    // placement of memory pages of the shared arrays on NUMA nodes
+    enum numa_plc_t 
+    { 
+      default_plc, // wherever the pages are first touched (i.e. mostly by the main thread)
+      first_touch, // each subdomain's part first touched by the thread owning the subdomain
+      interleave   // interleaved across all nodes (e.g. for decompositions finer than a page)
+    };
+
     namespace detail
     {
       template <
@@ -33,7 +56,35 @@ namespace libmpdataxx
 	static_assert(n_tlev > 0, "n_tlev <= 0");
 
         std::unique_ptr<blitz::Array<real_t, 1>> xtmtmp; 
-        std::unique_ptr<blitz::Array<double, 1>> sumtmp;
+        std::unique_ptr<blitz::Array<double, 2>> sumtmp;
+        std::unique_ptr<blitz::Array<double, 3>> rdctmp; // partial sums for batched reductions
+        std::array<std::unique_ptr<blitz::Array<double, 3>>, 2> rdcpipe; // and for pipelined ones
+        std::vector<int> rdcpipe_cnt; // number of pipelined reductions done by each thread
+
+        // per-subdomain counters of neighbour-only synchronisation points passed
+        // (padded to avoid false sharing)
+        struct epoch_t
+        {
+          std::atomic<unsigned long> n{0};
+          char pad[64 - sizeof(std::atomic<unsigned long>)];
+        };
+        std::vector<epoch_t> epochs;
+        std::vector<std::vector<int>> nghbrs; // ranks of neighbouring subdomains (incl. diagonal and periodic ones)
+
+        // halo-validity tracking: for each subdomain, a map from array data pointers 
+        // to the halo depth known to be valid (kept per subdomain as all subdomains 
+        // go through the same sequence of exchanges and modifications)
+        std::vector<std::unordered_map<const real_t*, int>> halo_valid;
+
+        // dynamic load balancing (see rebalance()): the first index of each slab along
+        // the first dimension (plus one past the last one) and the per-subdomain cost 
+        // measured since the last rebalancing
+        std::vector<int> slab_bnds;
+        std::vector<double> work, work_t0;
+
+        // result of a reduction across processes (see dist_reduce())
+        double dist_rslt;
+        std::vector<double> dist_rslts;
 
         protected:
 
@@ -41,10 +92,24 @@ namespace libmpdataxx
 
 	public:
 
+        detail::distmem distmem; // MPI processes (a single one if not built with USE_MPI)
+
 	int n = 0;
 	const int size;
-        std::array<rng_t, n_dims> grid_size; 
+        std::array<rng_t, n_dims> grid_size; // the part of the domain owned by this process
+        std::array<int, n_dims> decomp; // number of subdomains in each dimension
         bool panic = false; // for multi-threaded SIGTERM handling
+        bool nghbr_sync = false; // if true, nghbr_barrier() waits only for the neighbouring subdomains
+        bool halo_track = false; // if false, halos are never considered valid (i.e. no exchange skipped)
+        int rebalance_every = 0; // if positive, rebalance() is called by the solvers every so many time steps
+        unsigned long rebalance_cnt = 0; // number of times the slab boundaries were actually moved
+
+        // halo exchange statistics (per subdomain)
+        struct xchng_stats_t
+        {
+          unsigned long done = 0, skipped = 0, barriers_saved = 0;
+        };
+        std::vector<xchng_stats_t> xchng_stats;
 
         // TODO: these are public because used from outside in alloc - could friendship help?
 	arrvec_t<arr_t> GC, ndt_GC, ndtt_GC;
@@ -79,21 +144,291 @@ namespace libmpdataxx
 
         // ctors
         // TODO: fill reducetmp with NaNs (or use 1-element arrvec_t - it's NaN-filled by default)
-        sharedmem_common(const std::array<int, n_dims> &grid_size, const int &size)
-          : n(0), size(size) // TODO: is n(0) needed?
+        sharedmem_common(
+          const std::array<int, n_dims> &grid_size, 
+          const int &size,
+          const std::array<int, n_dims> &decomp = std::array<int, n_dims>(), // all zeros means automatic choice
+          const bool &hybrid = false // automatic choice of hybrid_decomp() instead of auto_decomp()
+        )
+          : epochs(size), n(0), size(size) // TODO: is n(0) needed?
         {
+          // with multiple processes, each gets a slab along the first dimension
+          // (indices remain global ones)
+          if (distmem.size() > grid_size[0])
+            throw std::runtime_error("number of processes greater than number of gridpoints in the first dimension");
+          std::array<int, n_dims> local_size;
           for (int d = 0; d < n_dims; ++d) 
           {
-            this->grid_size[d] = rng_t(0, grid_size[d]-1);
+            this->grid_size[d] = d == 0 
+              ? slab(rng_t(0, grid_size[d]-1), distmem.rank(), distmem.size())
+              : rng_t(0, grid_size[d]-1);
+            local_size[d] = this->grid_size[d].length();
             origin[d] = this->grid_size[d].first();
           }
 
-          if (size > grid_size[0]) 
-            throw std::runtime_error("number of subdomains greater than number of gridpoints");
+          this->decomp = decomp != std::array<int, n_dims>() ? decomp : hybrid 
+            ? hybrid_decomp(local_size, size, placement().n_packages()) 
+            : auto_decomp(local_size, size);
 
+          int n_subdomains = 1;
+          for (int d = 0; d < n_dims; ++d)
+          {
+            if (this->decomp[d] < 1)
+              throw std::runtime_error("non-positive number of subdomains requested");
+            if (this->decomp[d] > local_size[d]) 
+              throw std::runtime_error("number of subdomains greater than number of gridpoints");
+            n_subdomains *= this->decomp[d];
+          }
+          if (n_subdomains != size)
+            throw std::runtime_error("domain decomposition does not match the number of threads");
+
+          // partial sums are stored per row and per subdomain in the remaining dimensions
           if (n_dims != 1) 
-            sumtmp.reset(new blitz::Array<double, 1>(grid_size[0]));
+            sumtmp.reset(new blitz::Array<double, 2>(this->grid_size[0], rng_t(0, size / this->decomp[0] - 1)));
           xtmtmp.reset(new blitz::Array<real_t, 1>(size));
+
+          // initially equal slabs along the first dimension (as in concurr_common::init())
+          for (int i0 = 0; i0 < this->decomp[0]; ++i0) 
+            slab_bnds.push_back(slab(this->grid_size[0], i0, this->decomp[0]).first());
+          slab_bnds.push_back(this->grid_size[0].last() + 1);
+          work.resize(size, 0);
+          work_t0.resize(size, 0);
+
+          // neighbours of each subdomain, with the rank being a linear index 
+          // of the subdomain position in the process grid (as in concurr_common::init())
+          nghbrs.resize(size);
+          halo_valid.resize(size);
+          xchng_stats.resize(size);
+          for (int rank = 0; rank < size; ++rank)
+          {
+            std::array<int, n_dims> pos;
+            for (int d = n_dims - 1, r = rank; d >= 0; --d)
+            {
+              pos[d] = r % this->decomp[d];
+              r /= this->decomp[d];
+            }
+
+            int n_offsets = 1;
+            for (int d = 0; d < n_dims; ++d) n_offsets *= 3;
+            for (int o = 0; o < n_offsets; ++o)
+            {
+              int nrank = 0;
+              for (int d = 0, oo = o; d < n_dims; ++d, oo /= 3)
+                nrank = nrank * this->decomp[d] + (pos[d] + oo % 3 - 1 + this->decomp[d]) % this->decomp[d];
+              if (nrank != rank && std::find(nghbrs[rank].begin(), nghbrs[rank].end(), nrank) == nghbrs[rank].end())
+                nghbrs[rank].push_back(nrank);
+            }
+          }
+        }
+
+        /// @brief true if halos of arr were filled to at least a given depth since its last modification
+        bool halo_is_valid(const int &rank, const arr_t &arr, const int &depth) const
+        {
+          if (!halo_track) return false;
+          const auto it = halo_valid[rank].find(arr.data());
+          return it != halo_valid[rank].end() && it->second >= depth;
+        }
+
+        void halo_validate(const int &rank, const arr_t &arr, const int &depth)
+        {
+          if (halo_track) halo_valid[rank][arr.data()] = depth;
+        }
+
+        void halo_invalidate(const int &rank, const arr_t &arr)
+        {
+          halo_valid[rank].erase(arr.data());
+        }
+
+        void halo_invalidate(const int &rank)
+        {
+          halo_valid[rank].clear();
+        }
+
+        /// @brief point-to-point synchronisation with the neighbouring subdomains only 
+        ///        (sufficient around halo exchanges as long as subdomains are not narrower than the halo);
+        ///        falls back to a global barrier if nghbr_sync is not set
+        void nghbr_barrier(const int &rank)
+        {
+          nghbr_arrive(rank);
+          nghbr_wait(rank);
+        }
+
+        /// @brief split-phase nghbr_barrier(): signalling arrival without waiting 
+        ///        (no-op if nghbr_sync is not set)...
+        void nghbr_arrive(const int &rank)
+        {
+          if (nghbr_sync) epochs[rank].n.fetch_add(1, std::memory_order_acq_rel);
+        }
+
+        /// @brief ... and waiting for the neighbours to arrive (global barrier if nghbr_sync is not set)
+        void nghbr_wait(const int &rank)
+        {
+          if (!nghbr_sync) 
+          {
+            barrier();
+            return;
+          }
+
+          const unsigned long epoch = epochs[rank].n.load(std::memory_order_relaxed); // only modified by this rank
+          for (const int &nrank : nghbrs[rank])
+            while (epochs[nrank].n.load(std::memory_order_acquire) < epoch) 
+              std::this_thread::yield();
+        }
+
+        /// @brief accounting of the per-subdomain cost used in rebalance(): to be called by 
+        ///        each subdomain at the beginning and at the end of its work; measured as 
+        ///        the CPU time of the calling thread, so that time spent blocked at barriers 
+        ///        is not included (busy-waiting, e.g. with OpenMP barriers, is included though)
+        void work_begin(const int &rank)
+        {
+          work_t0[rank] = thread_cpu_time();
+        }
+
+        void work_end(const int &rank)
+        {
+          work[rank] += thread_cpu_time() - work_t0[rank];
+        }
+
+        /// @brief dynamic load balancing: to be called by all subdomains at the same point,
+        ///        moves the slab boundaries along the first dimension so that the cost 
+        ///        measured since the last call becomes equal (the cost of a slab being 
+        ///        that of its most expensive subdomain) and returns the new range of the
+        ///        slab the calling subdomain belongs to (not narrower than min_width, 
+        ///        unless the initial slabs were)
+        rng_t rebalance(const int &rank, const int &min_width)
+        {
+          work_end(rank);
+          barrier();
+          if (rank == 0)
+          {
+            const int n0 = decomp[0], per_slab = size / n0;
+            std::vector<double> slab_work(n0, 0);
+            for (int r = 0; r < size; ++r) 
+              slab_work[r / per_slab] = std::max(slab_work[r / per_slab], work[r]);
+            const auto bnds = balanced_bounds(
+              slab_bnds, slab_work, std::min(min_width, grid_size[0].length() / n0)
+            );
+            if (bnds != slab_bnds) 
+            {
+              slab_bnds = bnds;
+              rebalance_cnt++;
+            }
+          }
+          barrier();
+          const int i0 = rank / (size / decomp[0]);
+          work[rank] = 0;
+          work_begin(rank);
+          return rng_t(slab_bnds[i0], slab_bnds[i0 + 1] - 1);
+        }
+
+        const std::vector<int> &slab_bounds() const
+        {
+          return slab_bnds;
+        }
+
+        // slab boundaries equalising a given per-slab cost assuming it is uniformly distributed 
+        // within each slab (each boundary placed so that the cost left to the right of it is 
+        // shared equally by the remaining slabs), unchanged if the imbalance is within 
+        // the tolerance (to not react to timing noise)
+        static std::vector<int> balanced_bounds(
+          const std::vector<int> &bnds, 
+          const std::vector<double> &cost, 
+          const int &min_width,
+          const double &tolerance = .05
+        ) {
+          const int n = cost.size(), first = bnds.front(), len = bnds.back() - first;
+          const double mean = std::accumulate(cost.begin(), cost.end(), 0.) / n;
+          if (!(mean > 0) || *std::max_element(cost.begin(), cost.end()) <= (1 + tolerance) * mean) 
+            return bnds;
+
+          // cumulative cost at each column boundary
+          std::vector<double> cum(len + 1, 0);
+          for (int s = 0; s < n; ++s)
+            for (int c = bnds[s]; c < bnds[s + 1]; ++c)
+              cum[c - first + 1] = cum[c - first] + cost[s] / (bnds[s + 1] - bnds[s]);
+
+          std::vector<int> ret(bnds);
+          for (int q = 1; q < n; ++q)
+          {
+            const int lo = ret[q - 1] - first + min_width, hi = len - (n - q) * min_width;
+            const double target = cum[ret[q - 1] - first] + (cum[len] - cum[ret[q - 1] - first]) / (n - q + 1);
+            int c = std::lower_bound(cum.begin(), cum.end(), target) - cum.begin();
+            if (c > 0 && target - cum[c - 1] < cum[c] - target) --c;
+            ret[q] = first + std::max(lo, std::min(hi, c));
+          }
+          return ret;
+        }
+
+        // slabs along x if there are not more threads than columns, 
+        // pencils in x and y otherwise (the last dimension is never split automatically
+        // as surface-related code in some solvers assumes whole columns within a subdomain)
+        static std::array<int, n_dims> auto_decomp(const std::array<int, n_dims> &grid_size, const int &size)
+        {
+          std::array<int, n_dims> ret;
+          ret.fill(1);
+          ret[0] = size;
+
+          if (size <= grid_size[0] || n_dims < 3) return ret;
+
+          // choosing the factorisation with the least number of halo points
+          int cost = std::numeric_limits<int>::max();
+          for (int n0 = std::min(size, grid_size[0]); n0 > 0; --n0)
+          {
+            if (size % n0 != 0 || size / n0 > grid_size[1]) continue;
+            const int n1 = size / n0;
+            if ((n0 - 1) * grid_size[1] + (n1 - 1) * grid_size[0] < cost)
+            {
+              cost = (n0 - 1) * grid_size[1] + (n1 - 1) * grid_size[0];
+              ret[0] = n0;
+              ret[1] = n1;
+            }
+          }
+
+          if (cost == std::numeric_limits<int>::max()) 
+            throw std::runtime_error("could not find a domain decomposition for the number of threads, please set rt_params_t::decomp");
+          return ret;
+        }
+
+        // two-level decomposition: one slab along x per CPU package (socket), each split 
+        // among the package's threads along y (the slab being the unit of NUMA placement 
+        // and the pencils sharing the package's caches); as auto_decomp() in 1D and 2D 
+        // (where the last dimension is not split) or if the threads do not split evenly
+        static std::array<int, n_dims> hybrid_decomp(
+          const std::array<int, n_dims> &grid_size, 
+          const int &size, 
+          const int &n_pkgs
+        ) {
+          if (
+            n_dims < 3 || size % n_pkgs != 0 ||
+            n_pkgs > grid_size[0] || size / n_pkgs > grid_size[1]
+          ) return auto_decomp(grid_size, size);
+
+          std::array<int, n_dims> ret;
+          ret.fill(1);
+          ret[0] = n_pkgs;
+          ret[1] = size / n_pkgs;
+          return ret;
+        }
+
+        // maximal number of threads that can be used for a given process grid
+        static int max_size(const std::array<int, n_dims> &grid_size, const std::array<int, n_dims> &decomp)
+        {
+          int ret = 1;
+          if (decomp == std::array<int, n_dims>())
+            for (int d = 0; d < std::max(1, n_dims - 1); ++d) 
+              ret *= d == 0 ? grid_size[d] / detail::distmem().size() : grid_size[d]; // the narrowest slab
+          else
+            for (int d = 0; d < n_dims; ++d) ret *= decomp[d];
+          return ret;
+        }
+
+        // index of the subdomain in all but the first dimension
+        int rank_yz(const idx_t<n_dims> &ijk) const
+        {
+          int ret = 0;
+          for (int d = 1; d < n_dims; ++d)
+            ret = ret * decomp[d] + slab_rank(grid_size[d], ijk.lbound(d), decomp[d]);
+          return ret;
         }
 
         /// @brief concurrency-aware summation of array elements
@@ -101,6 +436,7 @@ namespace libmpdataxx
         {
 	  // doing a two-step sum to reduce numerical error 
 	  // and make parallel results reproducible
+          const int c_yz = rank_yz(ijk);
 	  for (int c = ijk[0].first(); c <= ijk[0].last(); ++c) // TODO: optimise for i.count() == 1
           {
             auto slice_idx = ijk;
@@ -108,9 +444,9 @@ namespace libmpdataxx
             slice_idx.ubound(0) = c;
 
             if (sum_khn)
-	      (*sumtmp)(c) = blitz::kahan_sum(arr(slice_idx));
+	      (*sumtmp)(c, c_yz) = blitz::kahan_sum(arr(slice_idx));
             else
-	      (*sumtmp)(c) = blitz::sum(arr(slice_idx));
+	      (*sumtmp)(c, c_yz) = blitz::sum(arr(slice_idx));
           }
           barrier();
           double result;
@@ -118,6 +454,8 @@ namespace libmpdataxx
             result = blitz::kahan_sum(*sumtmp);
           else
             result = blitz::sum(*sumtmp);
+          if (distmem.size() > 1) 
+            result = dist_reduce(result, first_subdomain(ijk), [&](const double &v) { return distmem.sum(v); });
           barrier();
           return result;
         }
@@ -127,6 +465,7 @@ namespace libmpdataxx
         {
 	  // doing a two-step sum to reduce numerical error 
 	  // and make parallel results reproducible
+          const int c_yz = rank_yz(ijk);
 	  for (int c = ijk[0].first(); c <= ijk[0].last(); ++c)
           {
             auto slice_idx = ijk;
@@ -134,9 +473,9 @@ namespace libmpdataxx
             slice_idx.ubound(0) = c;
 
             if (sum_khn)
-	      (*sumtmp)(c) = blitz::kahan_sum(arr1(slice_idx) * arr2(slice_idx));
+	      (*sumtmp)(c, c_yz) = blitz::kahan_sum(arr1(slice_idx) * arr2(slice_idx));
             else
-	      (*sumtmp)(c) = blitz::sum(arr1(slice_idx) * arr2(slice_idx)); 
+	      (*sumtmp)(c, c_yz) = blitz::sum(arr1(slice_idx) * arr2(slice_idx)); 
           }
           barrier();
           double result;
@@ -144,15 +483,174 @@ namespace libmpdataxx
             result = blitz::kahan_sum(*sumtmp);
           else
             result = blitz::sum(*sumtmp);
+          if (distmem.size() > 1) 
+            result = dist_reduce(result, first_subdomain(ijk), [&](const double &v) { return distmem.sum(v); });
+          barrier();
+          return result;
+        }
+
+        /// @brief to be called from solvers' alloc() to make room for batched reductions of up to n sums
+        void alloc_reduce(const int &n)
+        {
+          if (n_dims == 1) return; // as for sumtmp
+          if (rdctmp && rdctmp->extent(0) >= n) return;
+          rdctmp.reset(new blitz::Array<double, 3>(rng_t(0, n - 1), grid_size[0], rng_t(0, size / this->decomp[0] - 1)));
+        }
+
+        /// @brief concurrency-aware batched reduction: sums of (element-wise) products of pairs 
+        ///        of arrays (a null second pointer denotes a sum of the first array) and, 
+        ///        if absmax_arr is given, the maximum absolute value of it (appended as the last element
+        ///        of the returned vector) - all within a single pair of barriers; 
+        ///        the sums are bitwise identical to those returned by sum()
+        std::vector<double> reduce(
+          const int &rank,
+          const std::vector<std::pair<const arr_t*, const arr_t*>> &prods,
+          const idx_t<n_dims> &ijk, 
+          const bool sum_khn,
+          const arr_t *absmax_arr = nullptr
+        )
+        {
+          const int n_sums = prods.size();
+          assert(rdctmp && rdctmp->extent(0) >= n_sums && "alloc_reduce() not called?");
+
+          reduce_part(*rdctmp, prods, ijk, sum_khn);
+          if (absmax_arr != nullptr) (*xtmtmp)(rank) = blitz::max(blitz::abs((*absmax_arr)(ijk)));
+          barrier();
+          std::vector<double> result = reduce_sums(*rdctmp, n_sums, sum_khn);
+          if (absmax_arr != nullptr) result.push_back(blitz::max(*xtmtmp));
+          reduce_dist(rank, result, n_sums, absmax_arr != nullptr);
+          barrier();
+          return result;
+        }
+
+        /// @brief to be called from solvers' alloc() to make room for pipelined reductions of up to n sums
+        void alloc_reduce_pipe(const int &n)
+        {
+          if (n_dims == 1) return; // as for sumtmp
+          rdcpipe_cnt.assign(size, 0);
+          for (auto &buf : rdcpipe)
+          {
+            if (buf && buf->extent(0) >= n + 1) continue;
+            buf.reset(new blitz::Array<double, 3>(rng_t(0, n), grid_size[0], rng_t(0, size / this->decomp[0] - 1)));
+          }
+        }
+
+        /// @brief the first half of a pipelined reduction (as in reduce(), but without any synchronisation):
+        ///        the partial results of the calling thread, to be combined by reduce_wait() once some
+        ///        other work (without any other pipelined reductions) has been done
+        void reduce_post(
+          const int &rank,
+          const std::vector<std::pair<const arr_t*, const arr_t*>> &prods,
+          const idx_t<n_dims> &ijk, 
+          const bool sum_khn,
+          const arr_t *absmax_arr = nullptr
+        )
+        {
+          auto &buf = *rdcpipe[rdcpipe_cnt[rank] % 2];
+          assert(buf.extent(0) >= int(prods.size()) + 1 && "alloc_reduce_pipe() not called?");
+
+          reduce_part(buf, prods, ijk, sum_khn);
+          if (absmax_arr != nullptr)
+          {
+            // stored in all the elements of the thread in the row following the sums
+            buf(prods.size(), ijk[0], rank_yz(ijk)) = blitz::max(blitz::abs((*absmax_arr)(ijk)));
+          }
+        }
+
+        /// @brief the second half of a pipelined reduction (a single barrier, the buffers being alternated
+        ///        between consecutive reductions so that the next reduce_post() may follow without one)
+        std::vector<double> reduce_wait(
+          const int &rank,
+          const int &n_sums,
+          const bool sum_khn,
+          const bool absmax = false
+        )
+        {
+          const auto &buf = *rdcpipe[rdcpipe_cnt[rank]++ % 2];
+
           barrier();
+          std::vector<double> result = reduce_sums(buf, n_sums, sum_khn);
+          if (absmax) result.push_back(blitz::max(buf(n_sums, blitz::Range::all(), blitz::Range::all())));
+          reduce_dist(rank, result, n_sums, absmax);
           return result;
         }
 
+        private:
+
+        // partial sums of products over the rows of the subdomain along the first dimension
+        void reduce_part(
+          blitz::Array<double, 3> &buf,
+          const std::vector<std::pair<const arr_t*, const arr_t*>> &prods,
+          const idx_t<n_dims> &ijk, 
+          const bool sum_khn
+        )
+        {
+          const int c_yz = rank_yz(ijk);
+          for (int i = 0; i < int(prods.size()); ++i)
+          {
+	    for (int c = ijk[0].first(); c <= ijk[0].last(); ++c)
+            {
+              auto slice_idx = ijk;
+              slice_idx.lbound(0) = c;
+              slice_idx.ubound(0) = c;
+
+              const arr_t &arr1 = *prods[i].first;
+              if (prods[i].second == nullptr)
+              {
+                if (sum_khn)
+                  buf(i, c, c_yz) = blitz::kahan_sum(arr1(slice_idx));
+                else
+                  buf(i, c, c_yz) = blitz::sum(arr1(slice_idx));
+              }
+              else
+              {
+                const arr_t &arr2 = *prods[i].second;
+                if (sum_khn)
+                  buf(i, c, c_yz) = blitz::kahan_sum(arr1(slice_idx) * arr2(slice_idx));
+                else
+                  buf(i, c, c_yz) = blitz::sum(arr1(slice_idx) * arr2(slice_idx));
+              }
+            }
+          }
+        }
+
+        std::vector<double> reduce_sums(const blitz::Array<double, 3> &buf, const int n_sums, const bool sum_khn) const
+        {
+          std::vector<double> result(n_sums);
+          for (int i = 0; i < n_sums; ++i)
+          {
+            const blitz::Array<double, 2> part(buf(i, blitz::Range::all(), blitz::Range::all()));
+            if (sum_khn)
+              result[i] = blitz::kahan_sum(part);
+            else
+              result[i] = blitz::sum(part);
+          }
+          return result;
+        }
+
+        // combining the results across processes (the sums followed by the maximum, if any)
+        void reduce_dist(const int &rank, std::vector<double> &result, const int n_sums, const bool absmax)
+        {
+          if (distmem.size() == 1) return;
+          if (rank == 0)
+          {
+            dist_rslts.assign(result.begin(), result.begin() + n_sums);
+            distmem.sum(dist_rslts);
+            if (absmax) dist_rslts.push_back(distmem.max(result[n_sums]));
+          }
+          barrier();
+          result = dist_rslts;
+        }
+
+        public:
+
         real_t min(const int &rank, const arr_t &arr)
         {
           (*xtmtmp)(rank) = blitz::min(arr); 
           barrier();
           real_t result = blitz::min(*xtmtmp);
+          if (distmem.size() > 1) 
+            result = dist_reduce(result, rank == 0, [&](const double &v) { return distmem.min(v); });
           barrier();
           return result;
         }
@@ -162,10 +660,33 @@ namespace libmpdataxx
           (*xtmtmp)(rank) = blitz::max(arr); 
           barrier();
           real_t result = blitz::max(*xtmtmp);
+          if (distmem.size() > 1) 
+            result = dist_reduce(result, rank == 0, [&](const double &v) { return distmem.max(v); });
           barrier();
           return result;
         }
 
+        private:
+
+        // true for the subdomain at the origin of the process's part of the domain
+        bool first_subdomain(const idx_t<n_dims> &ijk) const
+        {
+          for (int d = 0; d < n_dims; ++d)
+            if (ijk.lbound(d) != grid_size[d].first()) return false;
+          return true;
+        }
+
+        // combining results of a reduction across threads (known to all of them) across processes:
+        // communication done by one thread, the result passed to others through dist_rslt
+        // (to be followed by a barrier before dist_rslt can be reused)
+        template <class fun_t>
+        double dist_reduce(const double &val, const bool comm, const fun_t &fun)
+        {
+          if (comm) dist_rslt = fun(val);
+          barrier();
+          return dist_rslt;
+        }
+
         // this hack is introduced to allow to use neverDeleteData
         // and hence to not use BZ_THREADSAFE
         private:
@@ -186,6 +707,53 @@ namespace libmpdataxx
           return ret;
         }
 
+        /// @brief writes to the part of each array belonging to a given subdomain (halos included 
+        ///        at domain edges) so that, if called from the thread owning the subdomain, 
+        ///        the memory pages get placed on its NUMA node by the first-touch policy
+        ///        (no effect on arrays already touched, e.g. NaN-filled in debug builds)
+        void touch_subdomain(const idx_t<n_dims> &ijk)
+        {
+          for (auto &arr : tobefreed)
+          {
+            auto reg = ijk;
+            bool empty = false;
+            for (int d = 0; d < n_dims; ++d)
+            {
+              reg.lbound(d) = ijk.lbound(d) == grid_size[d].first() ? arr.lbound(d) : std::max(ijk.lbound(d), arr.lbound(d));
+              reg.ubound(d) = ijk.ubound(d) == grid_size[d].last()  ? arr.ubound(d) : std::min(ijk.ubound(d), arr.ubound(d));
+              if (reg.lbound(d) > reg.ubound(d)) empty = true;
+            }
+            if (empty) continue;
+#if !defined(NDEBUG)
+            arr(reg) = blitz::has_signalling_NaN(real_t()) ? blitz::signalling_NaN(real_t()) : blitz::quiet_NaN(real_t());
+#else
+            arr(reg) = 0; // as in freshly mapped pages
+#endif
+          }
+        }
+
+        /// @brief asks the kernel to interleave (and migrate if already placed) 
+        ///        the memory pages of all arrays across NUMA nodes (Linux only, a no-op elsewhere)
+        void interleave_pages()
+        {
+#if defined(__linux__) && defined(SYS_mbind)
+          const unsigned long mpol_interleave = 3, mpol_mf_move = 1 << 1; // as in <numaif.h>
+          const unsigned long nodemask = ~0ul; // nodes without memory or not allowed are masked out by the kernel
+          const std::uintptr_t page = sysconf(_SC_PAGESIZE);
+
+          for (auto &arr : tobefreed)
+          {
+            // only whole pages within the array
+            const std::uintptr_t 
+              beg = (reinterpret_cast<std::uintptr_t>(arr.dataFirst()) + page - 1) / page * page,
+              end = (reinterpret_cast<std::uintptr_t>(arr.dataFirst() + arr.numElements())) / page * page;
+            if (end <= beg) continue;
+            // failure is not critical (it is only a hint), hence the return value is ignored
+            syscall(SYS_mbind, beg, end - beg, mpol_interleave, &nodemask, 8 * sizeof(nodemask), mpol_mf_move);
+          }
+#endif
+        }
+
         private:
         // helper methods to define subdomain ranges
         static int min(const int &span, const int &rank, const int &size) 
@@ -198,6 +766,21 @@ namespace libmpdataxx
           return min(span, rank + 1, size) - 1;  
         }
 
+        static double thread_cpu_time()
+        {
+          timespec ts;
+          clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+          return ts.tv_sec + 1e-9 * ts.tv_nsec;
+        }
+
+        // inverse of slab(): rank of the subdomain starting at a given index
+        static int slab_rank(const rng_t &span, const int &first, const int &size)
+        {
+          for (int rank = 0; rank < size; ++rank)
+            if (span.first() + min(span.length(), rank, size) == first) return rank;
+          throw std::logic_error("index does not start any subdomain");
+        }
+
         public:
         static rng_t slab(
           const rng_t &span,
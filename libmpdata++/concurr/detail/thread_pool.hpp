@@ -0,0 +1,101 @@
+/** 
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ */
+
+#pragma once
+
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace libmpdataxx
+{
+  namespace concurr
+  {
+    namespace detail
+    {
+      // a pool of persistent worker threads, each bound to a fixed rank
+      // (i.e. always running the same subdomain's solver, so that
+      // its caches and memory placement stay warm between advance() calls);
+      // workers are woken up by incrementing a generation counter
+      template <class thread_t>
+      class thread_pool
+      {
+	std::mutex m_mutex;
+	std::condition_variable m_cond_work, m_cond_done;
+	std::size_t m_generation, m_pending;
+        bool m_stop;
+        std::function<void(const int)> m_task;
+        std::vector<std::unique_ptr<thread_t>> m_threads;
+
+        void worker(const int rank)
+        {
+          std::size_t gen = 0;
+          while (true)
+          {
+            {
+              std::unique_lock<std::mutex> lock(m_mutex);
+              while (gen == m_generation && !m_stop)
+                m_cond_work.wait(lock);
+              if (m_stop) return;
+              gen = m_generation;
+            }
+
+            m_task(rank);
+
+            {
+              std::unique_lock<std::mutex> lock(m_mutex);
+              if (--m_pending == 0) m_cond_done.notify_one();
+            }
+          }
+        }
+
+	public:
+
+        // ctor
+	explicit thread_pool(const int size) : 
+          m_generation(0),
+          m_pending(0),
+          m_stop(false)
+        {
+          for (int rank = 0; rank < size; ++rank)
+            m_threads.emplace_back(new thread_t(&thread_pool::worker, this, rank));
+        }
+
+        // dtor
+        ~thread_pool()
+        {
+          {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_stop = true;
+            m_cond_work.notify_all();
+          }
+          for (auto &th : m_threads) th->join();
+        }
+
+        int size() const 
+        {
+          return m_threads.size();
+        }
+
+        // runs task(rank) on every worker and waits for all of them to finish
+        void run(const std::function<void(const int)> &task)
+        {
+          std::unique_lock<std::mutex> lock(m_mutex);
+          m_task = task;
+          m_pending = m_threads.size();
+          m_generation++;
+          m_cond_work.notify_all();
+
+          while (m_pending != 0)
+            m_cond_done.wait(lock);
+        }
+      };
+    } // namespace detail
+  } // namespace concurr
+} // namespace libmpdataxx
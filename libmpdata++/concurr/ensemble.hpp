@@ -0,0 +1,201 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ */
+
+#pragma once
+
+#include <libmpdata++/concurr/detail/thread_pool.hpp>
+#include <libmpdata++/concurr/detail/barrier.hpp>
+#include <libmpdata++/concurr/detail/placement.hpp>
+#include <libmpdata++/concurr/detail/concurr_common.hpp>
+
+#include <boost/ptr_container/ptr_vector.hpp>
+#include <boost/timer/timer.hpp>
+
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <exception>
+#include <sstream>
+#include <vector>
+#include <type_traits>
+
+namespace libmpdataxx
+{
+  namespace concurr
+  {
+    // a driver for ensembles of independent simulations: a single pool of threads
+    // advances the members, split into workers (teams) of k threads, k being the number
+    // of subdomains of each member (1 for concurr::serial, set by OMP_NUM_THREADS and 
+    // rt_params_t::decomp for cxx11_thread or boost_thread); each worker takes the next 
+    // not-yet-advanced member and runs its k subdomains on its k threads - the members 
+    // are constructed with detail::ext_workers_t and hence have no threads of their own
+    // (concurr::openmp members are not supported as they synchronise with omp barriers)
+    template <class concurr_t>
+    class ensemble
+    {
+      public:
+
+      using rt_params_t = typename concurr_t::solver_t::rt_params_t;
+      using advance_arg_t = typename concurr_t::advance_arg_t;
+
+      static_assert(
+        std::is_constructible<concurr_t, const rt_params_t &, detail::ext_workers_t>::value,
+        "ensemble members have to be constructible with detail::ext_workers_t (serial, cxx11_thread or boost_thread, not openmp)"
+      );
+
+      // aggregated timing
+      struct stats_t
+      {
+        double wall_time = 0;    // of all advance() calls [s]
+        double member_steps = 0; // sum over members of the advance() arguments
+        double member_wall_time = 0; // sum over members of their advance() calls [s]
+
+        double member_steps_per_sec() const { return wall_time > 0 ? member_steps / wall_time : 0; }
+
+        // fraction of the workers' time spent advancing members (load balance)
+        double efficiency(const int n_workers) const
+        {
+          return wall_time > 0 ? member_wall_time / (n_workers * wall_time) : 0;
+        }
+      };
+
+      private:
+
+      boost::ptr_vector<concurr_t> members;
+      int team_size, n_teams;
+      std::unique_ptr<detail::thread_pool<std::thread>> threads;
+      boost::ptr_vector<detail::barrier> team_barriers;
+      std::vector<int> team_member; // member being advanced by a given team (written by its rank-0 thread)
+      stats_t st;
+
+      static int default_n_workers(const int n_members, const int member_threads)
+      {
+        return std::max(1, std::min(n_members, detail::placement().n_threads() / member_threads));
+      }
+
+      public:
+
+      // ctors
+      ensemble(
+        const std::vector<rt_params_t> &ps, // one per member
+        const int n_workers = 0             // 0 means all available cores
+      )
+      {
+        if (ps.empty()) throw std::runtime_error("ensemble with no members requested");
+        for (const auto &p : ps) members.push_back(new concurr_t(p, detail::ext_workers_t()));
+
+        team_size = members[0].n_threads();
+        for (const auto &m : members) 
+          if (m.n_threads() != team_size) 
+            throw std::runtime_error("ensemble members with different numbers of subdomains");
+
+        n_teams = n_workers > 0 ? n_workers : default_n_workers(members.size(), team_size);
+        for (int t = 0; t < n_teams; ++t) team_barriers.push_back(new detail::barrier(team_size));
+        team_member.resize(n_teams);
+        threads.reset(new detail::thread_pool<std::thread>(n_teams * team_size));
+
+        // first touch of the members' memory, round robin over the teams
+        threads->run([&](const int th)
+        {
+          const int t = th / team_size, rank = th % team_size;
+          for (int m = t; m < int(members.size()); m += n_teams)
+            members[m].ext_init(rank, ps[m]);
+        });
+      }
+
+      ensemble(
+        const int n_members,
+        const rt_params_t &p,
+        const int n_workers = 0
+      ) :
+        ensemble(std::vector<rt_params_t>(n_members, p), n_workers)
+      {}
+
+      // dtor
+      ~ensemble()
+      {
+        print_stats();
+      }
+
+      int size() const
+      {
+        return members.size();
+      }
+
+      // number of members advanced concurrently (each on team_size threads)
+      int n_workers() const
+      {
+        return n_teams;
+      }
+
+      // access to members (e.g. for setting perturbed initial conditions)
+      concurr_t &operator[](const int m)
+      {
+        return members[m];
+      }
+
+      /// @brief advances all members by nt (members are picked up dynamically by the workers)
+      void advance(const advance_arg_t nt)
+      {
+        std::atomic<int> next(0);
+        std::vector<double> member_wall(members.size(), 0);
+        std::exception_ptr error;
+        std::mutex error_mutex;
+
+        boost::timer::cpu_timer tmr;
+        threads->run([&](const int th)
+        {
+          const int t = th / team_size, rank = th % team_size;
+          while (true)
+          {
+            if (rank == 0) team_member[t] = next++;
+            team_barriers[t].wait();
+            const int m = team_member[t];
+            if (m >= int(members.size())) break;
+
+            boost::timer::cpu_timer member_tmr;
+            try
+            {
+              members[m].ext_solve(rank, nt);
+            }
+            catch (...)
+            {
+              std::lock_guard<std::mutex> lock(error_mutex);
+              if (!error) error = std::current_exception();
+            }
+            if (rank == 0) member_wall[m] = double(member_tmr.elapsed().wall) * 1e-9;
+
+            // the whole team done before its rank-0 thread picks the next member
+            team_barriers[t].wait();
+          }
+        });
+
+        st.wall_time += double(tmr.elapsed().wall) * 1e-9;
+        st.member_steps += double(nt) * members.size();
+        for (const auto &w : member_wall) st.member_wall_time += w;
+
+        if (error) std::rethrow_exception(error);
+      }
+
+      const stats_t &stats() const
+      {
+        return st;
+      }
+
+      void print_stats() const
+      {
+        std::ostringstream tmp;
+        tmp << " ensemble of " << size() << " members on " << n_workers() << " workers";
+        tmp << " of " << team_size << " thread(s):";
+        tmp << " wall time: " << st.wall_time << "s";
+        tmp << " member-steps/s: " << st.member_steps_per_sec();
+        tmp << " worker efficiency: " << st.efficiency(n_workers());
+        std::cerr << tmp.str() << std::endl;
+      }
+    };
+  } // namespace concurr
+} // namespace libmpdataxx
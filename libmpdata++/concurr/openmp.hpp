@@ -40,7 +40,7 @@ namespace libmpdataxx
 	  const char *env_var("OMP_NUM_THREADS");
 
 	  int nthreads = std::min(max_threads, static_cast<unsigned>(
-            (std::getenv(env_var) != NULL) ?  std::atoi(std::getenv(env_var)) : omp_get_max_threads()
+            (std::getenv(env_var) != NULL) ?  std::atoi(std::getenv(env_var)) : std::min(omp_get_max_threads(), detail::placement().n_threads())
           ));
 
           omp_set_num_threads(nthreads);
@@ -58,7 +58,11 @@ namespace libmpdataxx
         }
 
         // ctors
-        mem_t(const std::array<int, solver_t::n_dims> &grid_size) : parent_t::mem_t(grid_size, size(grid_size[0])) {};
+        mem_t(
+          const std::array<int, solver_t::n_dims> &grid_size,
+          const std::array<int, solver_t::n_dims> &decomp,
+          const bool &hybrid
+        ) : parent_t::mem_t(grid_size, size(parent_t::mem_t::max_size(grid_size, decomp)), decomp, hybrid) {};
       };
 
       void solve(typename parent_t::advance_arg_t nt)
@@ -77,8 +81,17 @@ namespace libmpdataxx
 
       // ctor
       openmp(const typename solver_t::rt_params_t &p) : 
-        parent_t(p, new mem_t(p.grid_size), mem_t::size(p.grid_size[0]))
-      {}
+        parent_t(p, new mem_t(p.grid_size, p.decomp, p.hybrid))
+      {
+        int i = 0;
+#pragma omp parallel private(i)
+        {
+#if defined(_OPENMP)
+          i = omp_get_thread_num();
+#endif
+          this->thread_init(i, p);
+        }
+      }
 
     };
   } // namespace concurr
@@ -47,7 +47,14 @@ namespace libmpdataxx
 
       // ctor
       serial(const typename solver_t::rt_params_t &p) : 
-        parent_t(p, new mem_t(p.grid_size), mem_t::size())
+        parent_t(p, new mem_t(p.grid_size))
+      {
+        this->thread_init(0, p);
+      }
+
+      // ctor leaving the first touch to the caller (see ext_init() and ext_solve())
+      serial(const typename solver_t::rt_params_t &p, detail::ext_workers_t) : 
+        parent_t(p, new mem_t(p.grid_size))
       {}
 
     };
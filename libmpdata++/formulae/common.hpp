@@ -19,6 +19,14 @@ namespace libmpdataxx
     {
       return static_cast<typename arr_t::T_numtype>(v);
     }
+    // type of the arithmetic in the point-wise flux and donor-cell kernels only (see opts::mpr)
+    template<opts::opts_t opts, class real_t>
+    using cmpt_t = typename std::conditional<
+      opts::isset(opts, opts::mpr),
+      typename std::common_type<real_t, double>::type,
+      real_t
+    >::type;
+
     // overloads of abs/min/max/where that pick out the correct version based on ix_t
     template<class ix_t, class arg_t>
     forceinline_macro auto abs(const arg_t &a, typename std::enable_if<std::is_same<ix_t, int>::value>::type* = 0)
@@ -9,6 +9,7 @@
 #include <libmpdata++/formulae/idxperm.hpp>
 #include <libmpdata++/formulae/common.hpp>
 #include <libmpdata++/formulae/kahan_sum.hpp>
+#include <libmpdata++/formulae/simd.hpp>
 
 namespace libmpdataxx
 {
@@ -164,6 +165,209 @@ namespace libmpdataxx
         }
       }
 
+      // point-wise versions of the above used in the loops below (the same operations
+      // in the same order, hence the same results as with the blitz expressions)
+      template <opts_t opts, class real_t>
+      forceinline_macro real_t F_pt(const real_t &psi_l, const real_t &psi_r, const real_t &GC)
+      {
+        return 
+          pospart<opts, int>(GC) * psi_l + 
+          negpart<opts, int>(GC) * psi_r;
+      }
+
+      template <opts_t opts, class real_t, class g_t>
+      forceinline_macro real_t donorcell_pt(
+        const real_t &psi_old, 
+        const real_t &flx_1, const real_t &flx_2,
+        const g_t &g
+      )
+      {
+        if (!opts::isset(opts, opts::khn)) return psi_old + (-flx_1 + flx_2) / g;
+        kahan_pt<real_t> ks;
+        ks.add(psi_old);
+        ks.add(-flx_1 / g);
+        ks.add( flx_2 / g);
+        return ks.sum;
+      }
+
+      template <opts_t opts, class real_t, class g_t>
+      forceinline_macro real_t donorcell_pt(
+        const real_t &psi_old, 
+        const real_t &flx_1, const real_t &flx_2,
+        const real_t &flx_3, const real_t &flx_4,
+        const g_t &g
+      )
+      {
+        if (!opts::isset(opts, opts::khn)) return psi_old + ((-flx_1 + flx_2) + (-flx_3 + flx_4)) / g;
+        kahan_pt<real_t> ks;
+        ks.add(psi_old);
+        ks.add(-flx_1 / g);
+        ks.add( flx_2 / g);
+        ks.add(-flx_3 / g);
+        ks.add( flx_4 / g);
+        return ks.sum;
+      }
+
+      template <opts_t opts, class real_t, class g_t>
+      forceinline_macro real_t donorcell_pt(
+        const real_t &psi_old, 
+        const real_t &flx_1, const real_t &flx_2,
+        const real_t &flx_3, const real_t &flx_4,
+        const real_t &flx_5, const real_t &flx_6,
+        const g_t &g
+      )
+      {
+        if (!opts::isset(opts, opts::khn)) return psi_old + ((-flx_1 + flx_2) + (-flx_3 + flx_4) + (-flx_5 + flx_6)) / g;
+        kahan_pt<real_t> ks;
+        ks.add(psi_old);
+        ks.add(-flx_1 / g);
+        ks.add( flx_2 / g);
+        ks.add(-flx_3 / g);
+        ks.add( flx_4 / g);
+        ks.add(-flx_5 / g);
+        ks.add( flx_6 / g);
+        return ks.sum;
+      }
+
+      // loops over points computing the fluxes and the donor-cell update, run on contiguous views
+      // (and hence vectorised, see formulae/simd.hpp) if possible, and on the blitz arrays otherwise;
+      // the arithmetic is done in cm_t (wider than the array element type if opts::mpr is set)
+      template <opts_t opts, class cm_t, class flx_t, class psi_t, class GC_t>
+      forceinline_macro void calc_flux_loop(flx_t &flx, const psi_t &psi, const GC_t &GC, const rng_t &ir)
+      {
+        simd::for_each<0>(ir, [&](const int i)
+        {
+          flx(i+h) = F_pt<opts>(cm_t(psi(i)), cm_t(psi(i+1)), cm_t(GC(i+h)));
+        });
+      }
+
+      template <opts_t opts, int d, class cm_t, class flx_t, class psi_t, class GC_t>
+      forceinline_macro void calc_flux_loop(flx_t &flx, const psi_t &psi, const GC_t &GC, const rng_t &ir, const rng_t &jr)
+      {
+        simd::for_each<d>(ir, jr, [&](const int i, const int j)
+        {
+          flx(pi<d>(i+h, j)) = F_pt<opts>(cm_t(psi(pi<d>(i, j))), cm_t(psi(pi<d>(i+1, j))), cm_t(GC(pi<d>(i+h, j))));
+        });
+      }
+
+      template <opts_t opts, int d, class cm_t, class flx_t, class psi_t, class GC_t>
+      forceinline_macro void calc_flux_loop(flx_t &flx, const psi_t &psi, const GC_t &GC, const rng_t &ir, const rng_t &jr, const rng_t &kr)
+      {
+        simd::for_each<d>(ir, jr, kr, [&](const int i, const int j, const int k)
+        {
+          flx(pi<d>(i+h, j, k)) = F_pt<opts>(cm_t(psi(pi<d>(i, j, k))), cm_t(psi(pi<d>(i+1, j, k))), cm_t(GC(pi<d>(i+h, j, k))));
+        });
+      }
+
+      // flx(i+h) = make_flux(psi, GC, i)
+      template <opts_t opts, class arr_1d_t>
+      inline void calc_flux(arr_1d_t &flx, const arr_1d_t &psi, const arr_1d_t &GC, const rng_t &i)
+      {
+        using real_t = typename arr_1d_t::T_numtype;
+        if (simd::cntg(flx, psi, GC))
+        {
+          simd::cntg_arr_t<real_t, 1> flx_c(flx);
+          calc_flux_loop<opts, cmpt_t<opts, real_t>>(flx_c, simd::cntg_arr_t<const real_t, 1>(psi), simd::cntg_arr_t<const real_t, 1>(GC), i);
+        }
+        else calc_flux_loop<opts, cmpt_t<opts, real_t>>(flx, psi, GC, i);
+      }
+
+      // flx(pi<d>(i+h, j)) = make_flux<d>(psi, GC, i, j)
+      template <opts_t opts, int d, class arr_2d_t>
+      inline void calc_flux(arr_2d_t &flx, const arr_2d_t &psi, const arr_2d_t &GC, const rng_t &i, const rng_t &j)
+      {
+        using real_t = typename arr_2d_t::T_numtype;
+        if (simd::cntg(flx, psi, GC))
+        {
+          simd::cntg_arr_t<real_t, 2> flx_c(flx);
+          calc_flux_loop<opts, d, cmpt_t<opts, real_t>>(flx_c, simd::cntg_arr_t<const real_t, 2>(psi), simd::cntg_arr_t<const real_t, 2>(GC), i, j);
+        }
+        else calc_flux_loop<opts, d, cmpt_t<opts, real_t>>(flx, psi, GC, i, j);
+      }
+
+      // flx(pi<d>(i+h, j, k)) = make_flux<d>(psi, GC, i, j, k)
+      template <opts_t opts, int d, class arr_3d_t>
+      inline void calc_flux(arr_3d_t &flx, const arr_3d_t &psi, const arr_3d_t &GC, const rng_t &i, const rng_t &j, const rng_t &k)
+      {
+        using real_t = typename arr_3d_t::T_numtype;
+        if (simd::cntg(flx, psi, GC))
+        {
+          simd::cntg_arr_t<real_t, 3> flx_c(flx);
+          calc_flux_loop<opts, d, cmpt_t<opts, real_t>>(flx_c, simd::cntg_arr_t<const real_t, 3>(psi), simd::cntg_arr_t<const real_t, 3>(GC), i, j, k);
+        }
+        else calc_flux_loop<opts, d, cmpt_t<opts, real_t>>(flx, psi, GC, i, j, k);
+      }
+
+      template <opts_t opts, class cm_t, class psi_new_t, class psi_t, class flx_t, class G_t>
+      forceinline_macro void donorcell_loop(psi_new_t &psi_new, const psi_t &psi_old, const flx_t &flx, const G_t &G, const rng_t &ir)
+      {
+        simd::for_each<0>(ir, [&](const int i)
+        {
+          psi_new(i) = donorcell_pt<opts>(
+            cm_t(psi_old(i)),
+            cm_t(flx[0](i+h)), cm_t(flx[0](i-h)),
+            formulae::G<opts>(G, i)
+          );
+        });
+      }
+
+      template <opts_t opts, class cm_t, class psi_new_t, class psi_t, class flx_t, class G_t>
+      forceinline_macro void donorcell_loop(psi_new_t &psi_new, const psi_t &psi_old, const flx_t &flx, const G_t &G, const rng_t &ir, const rng_t &jr)
+      {
+        simd::for_each<0>(ir, jr, [&](const int i, const int j)
+        {
+          psi_new(i, j) = donorcell_pt<opts>(
+            cm_t(psi_old(i, j)),
+            cm_t(flx[0](i+h, j)), cm_t(flx[0](i-h, j)),
+            cm_t(flx[1](i, j+h)), cm_t(flx[1](i, j-h)),
+            formulae::G<opts, 0>(G, i, j)
+          );
+        });
+      }
+
+      template <opts_t opts, class cm_t, class psi_new_t, class psi_t, class flx_t, class G_t>
+      forceinline_macro void donorcell_loop(psi_new_t &psi_new, const psi_t &psi_old, const flx_t &flx, const G_t &G, const rng_t &ir, const rng_t &jr, const rng_t &kr)
+      {
+        simd::for_each<0>(ir, jr, kr, [&](const int i, const int j, const int k)
+        {
+          psi_new(i, j, k) = donorcell_pt<opts>(
+            cm_t(psi_old(i, j, k)),
+            cm_t(flx[0](i+h, j, k)), cm_t(flx[0](i-h, j, k)),
+            cm_t(flx[1](i, j+h, k)), cm_t(flx[1](i, j-h, k)),
+            cm_t(flx[2](i, j, k+h)), cm_t(flx[2](i, j, k-h)),
+            formulae::G<opts, 0>(G, i, j, k)
+          );
+        });
+      }
+
+      // the same as donorcell_sum() over the ranges given as the last arguments
+      // (the khn_tmp arrays are not needed as the Kahan compensation is kept in a local variable)
+      template <opts_t opts, class arr_t, class... rngs_t>
+      inline void donorcell(
+        arr_t &psi_new,
+        const arr_t &psi_old,
+        const arrvec_t<arr_t> &flx,
+        const arr_t &G,
+        const rngs_t &... rngs
+      )
+      {
+        using real_t = typename arr_t::T_numtype;
+        constexpr int n_dims = arr_t::rank_;
+        static_assert(sizeof...(rngs) == n_dims, "one range per dimension expected");
+
+        bool cntg = simd::cntg(psi_new, psi_old) && simd::cntg_G<opts>(G);
+        for (int d = 0; d < n_dims; ++d) cntg = cntg && simd::cntg(flx[d]);
+
+        if (cntg) 
+        {
+          simd::cntg_arr_t<real_t, n_dims> psi_new_c(psi_new);
+          donorcell_loop<opts, cmpt_t<opts, real_t>>(
+            psi_new_c, simd::cntg_arr_t<const real_t, n_dims>(psi_old), simd::cntg_vec<const real_t, n_dims>(flx), simd::G_arr<opts>(G), rngs...
+          );
+        }
+        else donorcell_loop<opts, cmpt_t<opts, real_t>>(psi_new, psi_old, flx, G, rngs...);
+      }
+
     } // namespace donorcell 
   } // namespace formulae
 } // namespace libmpdataxx
@@ -25,5 +25,20 @@ namespace libmpdataxx
       c = (t - sum) - y;
       sum = t;
     }
+
+    // point-wise version of the above (with the compensation kept in a local variable)
+    template <class real_t>
+    struct kahan_pt
+    {
+      real_t c = 0, sum = 0;
+
+      template <class f_t>
+      inline void add(const f_t &input)
+      {
+        const real_t y = input - c, t = sum + y;
+        c = (t - sum) - y;
+        sum = t;
+      }
+    };
   }
 }
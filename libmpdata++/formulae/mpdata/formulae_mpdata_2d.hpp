@@ -238,6 +238,35 @@ namespace libmpdataxx
         );
       }
       
+      // antidiffusive velocity at (i+1/2, j) - standard version
+      // (point-wise, also used in the single-pass corrective iteration, see mpdata_osc_2d::advop_single_pass())
+      template <opts_t opts, int dim, class arr_2d_t>
+      forceinline_macro typename arr_2d_t::T_numtype antidiff_pt(
+        const arr_2d_t &psi, 
+        const arrvec_t<arr_2d_t> &GC,
+        const arr_2d_t &G, 
+        const int i, 
+        const int j
+      ) 
+      {
+        return 
+          // second order terms
+          abs(GC[dim](pi<dim>(i+h, j))) / 2
+          * (1 - abs(GC[dim](pi<dim>(i+h, j))) / G_bar_x<opts, dim>(G, i, j))
+          * ndx_psi<opts, dim>(psi, i, j) 
+          - 
+          GC[dim](pi<dim>(i+h, j)) 
+          * GC1_bar_xy<dim>(GC[dim+1], i, j)
+          / (2 * G_bar_x<opts, dim>(G, i, j))
+          * ndy_psi<opts, dim>(psi, i, j)
+          // third order terms
+          + TOT<opts, dim>(psi, GC, G, i, j)
+          //// fourth order terms
+          + FOT<opts, dim>(psi, GC, G, i, j)
+          // divergent flow correction
+          + DFL<opts, dim>(psi, GC, G, i, j);
+      }
+
       // antidiffusive velocity - standard version
       template <opts_t opts, int dim, solvers::sptl_intrp_t, solvers::tmprl_extrp_t, class arr_2d_t>
       inline void antidiff(
@@ -257,22 +286,7 @@ namespace libmpdataxx
         {
           for (int j = jr.first(); j <= jr.last(); ++j)
           {
-            res(pi<dim>(i, j)) = 
-            // second order terms
-            abs(GC[dim](pi<dim>(i+h, j))) / 2
-            * (1 - abs(GC[dim](pi<dim>(i+h, j))) / G_bar_x<opts, dim>(G, i, j))
-            * ndx_psi<opts, dim>(psi_np1, i, j) 
-            - 
-            GC[dim](pi<dim>(i+h, j)) 
-            * GC1_bar_xy<dim>(GC[dim+1], i, j)
-            / (2 * G_bar_x<opts, dim>(G, i, j))
-            * ndy_psi<opts, dim>(psi_np1, i, j)
-            // third order terms
-            + TOT<opts, dim>(psi_np1, GC, G, i, j)
-            //// fourth order terms
-            + FOT<opts, dim>(psi_np1, GC, G, i, j)
-            // divergent flow correction
-            + DFL<opts, dim>(psi_np1, GC, G, i, j);
+            res(pi<dim>(i, j)) = antidiff_pt<opts, dim>(psi_np1, GC, G, i, j);
           }
         }
       }
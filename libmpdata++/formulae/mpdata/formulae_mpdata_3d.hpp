@@ -250,6 +250,37 @@ namespace libmpdataxx
         );
       }
 
+      // antidiffusive velocity at (i+1/2, j, k) - standard version
+      // (point-wise, also used in the single-pass corrective iteration, see mpdata_osc_3d::advop_single_pass())
+      template <opts_t opts, int dim, class arr_3d_t>
+      forceinline_macro typename arr_3d_t::T_numtype antidiff_pt(
+        const arr_3d_t &psi,
+        const arrvec_t<arr_3d_t> &GC,
+        const arr_3d_t &G,
+        const int i,
+        const int j,
+        const int k
+      )
+      {
+        return
+            // second order terms
+            abs(GC[dim](pi<dim>(i+h, j, k))) / 2
+          * (1 - abs(GC[dim](pi<dim>(i+h, j, k))) / G_bar_x<opts, dim>(G, i, j, k))
+          * ndx_psi<opts, dim>(psi, i, j, k)
+          - GC[dim](pi<dim>(i+h, j, k)) / 2
+          * (
+              GC1_bar_xy<dim>(GC[dim+1], i, j, k)
+            * ndy_psi<opts, dim>(psi, i, j, k)
+            + GC2_bar_xz<dim>(GC[dim-1], i, j, k)
+            * ndz_psi<opts, dim>(psi, i, j, k)
+            )
+            / G_bar_x<opts, dim>(G, i, j, k)
+            // third order terms
+          + TOT<opts, dim>(psi, GC, G, i, j, k)
+          // divergent flow correction
+          + DFL<opts, dim>(psi, GC, G, i, j, k);
+      }
+
       // antidiffusive velocity - standard version
       template <opts_t opts, int dim, solvers::sptl_intrp_t, solvers::tmprl_extrp_t, class arr_3d_t>
       inline void antidiff(
@@ -272,23 +303,7 @@ namespace libmpdataxx
           {
             for (int k = kr.first(); k <= kr.last(); ++k)
             {
-              res(pi<dim>(i, j, k)) = 
-                // second order terms
-                abs(GC[dim](pi<dim>(i+h, j, k))) / 2
-              * (1 - abs(GC[dim](pi<dim>(i+h, j, k))) / G_bar_x<opts, dim>(G, i, j, k))
-              * ndx_psi<opts, dim>(psi_np1, i, j, k)
-              - GC[dim](pi<dim>(i+h, j, k)) / 2
-              * (
-                  GC1_bar_xy<dim>(GC[dim+1], i, j, k)
-                * ndy_psi<opts, dim>(psi_np1, i, j, k)
-                + GC2_bar_xz<dim>(GC[dim-1], i, j, k)
-                * ndz_psi<opts, dim>(psi_np1, i, j, k)
-                )
-                / G_bar_x<opts, dim>(G, i, j, k)
-                // third order terms
-              + TOT<opts, dim>(psi_np1, GC, G, i, j, k)
-              // divergent flow correction
-              + DFL<opts, dim>(psi_np1, GC, G, i, j, k);
+              res(pi<dim>(i, j, k)) = antidiff_pt<opts, dim>(psi_np1, GC, G, i, j, k);
             }
           }
         }
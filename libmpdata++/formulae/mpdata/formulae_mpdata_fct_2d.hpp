@@ -7,6 +7,7 @@
 #pragma once
 
 #include <libmpdata++/formulae/mpdata/formulae_mpdata_common.hpp>
+#include <libmpdata++/formulae/simd.hpp>
 #include <boost/preprocessor/punctuation/comma.hpp>
 
 namespace libmpdataxx
@@ -16,13 +17,57 @@ namespace libmpdataxx
     namespace mpdata
     {
       using namespace arakawa_c;
+
+      // extrema of psi in the neighbourhood of each point (before the first corrective iteration)
+      template <class arr_2d_t>
+      forceinline_macro void psi_min_max(
+        arr_2d_t &psi_min,
+        arr_2d_t &psi_max,
+        const arr_2d_t &psi,
+        const rng_t &ir,
+        const rng_t &jr
+      )
+      {
+        if (!simd::cntg(psi_min, psi_max, psi))
+        {
+	  psi_min(ir,jr) = min(min(min(min(
+			   psi(ir,jr+1),
+	    psi(ir-1,jr)), psi(ir,jr  )), psi(ir+1,jr)),
+			   psi(ir,jr-1)
+	  );
+	  psi_max(ir,jr) = max(max(max(max(
+			   psi(ir,jr+1),
+	    psi(ir-1,jr)), psi(ir,jr  )), psi(ir+1,jr)), 
+			   psi(ir,jr-1)
+	  ); 
+          return;
+        }
+
+        using ix_t = int;
+        using real_t = typename arr_2d_t::T_numtype;
+        const simd::cntg_arr_t<real_t, 2> mn(psi_min), mx(psi_max);
+        const simd::cntg_arr_t<const real_t, 2> p(psi);
+        simd::for_each<0>(ir, jr, [&](const int i, const int j)
+        {
+          mn(i, j) = min<ix_t>(min<ix_t>(min<ix_t>(min<ix_t>(
+                         p(i,   j+1),
+            p(i-1, j)), p(i,   j  )), p(i+1, j)),
+                         p(i,   j-1)
+          );
+          mx(i, j) = max<ix_t>(max<ix_t>(max<ix_t>(max<ix_t>(
+                         p(i,   j+1),
+            p(i-1, j)), p(i,   j  )), p(i+1, j)),
+                         p(i,   j-1)
+          );
+        });
+      }
  
       //see Smolarkiewicz & Grabowski 1990 (J.Comp.Phys.,86,355-375)
-      template <opts_t opts, class arr_2d_t, class ix_t>
+      template <opts_t opts, class arr_2d_t, class G_t, class ix_t>
       forceinline_macro auto beta_up_nominator(
         const arr_2d_t &psi,
         const arr_2d_t &psi_max,
-        const arr_2d_t &G,
+        const G_t &G,
         const ix_t &i,  
         const ix_t &j
       )
@@ -38,6 +83,33 @@ namespace libmpdataxx
         );
       }
 
+      template <opts_t opts, class b_t, class psi_t, class flx_t, class G_t>
+      forceinline_macro void beta_up_loop(
+        b_t &b,
+        const psi_t &psi,
+        const psi_t &psi_max,
+        const flx_t &flx,
+        const G_t &G,
+        const rng_t &ir,  
+        const rng_t &jr
+      )
+      {
+        using ix_t = int;
+        simd::for_each<0>(ir, jr, [&](const int i, const int j)
+        {
+          b(i, j) = 
+          fct_frac<ix_t>(
+            beta_up_nominator<opts>(psi, psi_max, G, i, j)
+            , // -----------------------------------------------------------
+            ( pospart<opts, ix_t>(flx[0](i-h, j))
+            - negpart<opts, ix_t>(flx[0](i+h, j)) )  // additional parenthesis so that we first sum
+            +                                                        // fluxes in separate dimensions 
+            ( pospart<opts, ix_t>(flx[1](i, j-h))    // could be important for accuracy if one of them
+            - negpart<opts, ix_t>(flx[1](i, j+h)) )  // is of different magnitude than the other
+          );
+        });
+      }
+
       template <opts_t opts, class arr_2d_t, class flx_t>
       forceinline_macro void beta_up(
         arr_2d_t &b,
@@ -49,30 +121,21 @@ namespace libmpdataxx
         const rng_t &jr
       )
       {
-        using ix_t = int;
-        for (int i = ir.first(); i <= ir.last(); ++i)
+        using real_t = typename arr_2d_t::T_numtype;
+        if (simd::cntg(b, psi, psi_max, flx[0], flx[1]) && simd::cntg_G<opts>(G))
         {
-          for (int j = jr.first(); j <= jr.last(); ++j)
-          {
-            b(i, j) = 
-            fct_frac<ix_t>(
-              beta_up_nominator<opts>(psi, psi_max, G, i, j)
-              , // -----------------------------------------------------------
-              ( pospart<opts, ix_t>(flx[0](i-h, j))
-              - negpart<opts, ix_t>(flx[0](i+h, j)) )  // additional parenthesis so that we first sum
-              +                                                        // fluxes in separate dimensions 
-              ( pospart<opts, ix_t>(flx[1](i, j-h))    // could be important for accuracy if one of them
-              - negpart<opts, ix_t>(flx[1](i, j+h)) )  // is of different magnitude than the other
-            );
-          }
+          simd::cntg_arr_t<real_t, 2> b_c(b);
+          const simd::cntg_arr_t<const real_t, 2> psi_c(psi), psi_max_c(psi_max);
+          beta_up_loop<opts>(b_c, psi_c, psi_max_c, simd::cntg_vec<const real_t, 2>(flx), simd::G_arr<opts>(G), ir, jr);
         }
+        else beta_up_loop<opts>(b, psi, psi_max, flx, G, ir, jr);
       } 
 
-      template <opts_t opts, class arr_2d_t, class ix_t>
+      template <opts_t opts, class arr_2d_t, class G_t, class ix_t>
       forceinline_macro auto beta_dn_nominator(
         const arr_2d_t &psi, 
         const arr_2d_t &psi_min,
-        const arr_2d_t &G, 
+        const G_t &G, 
         const ix_t &i,
         const ix_t &j 
       )
@@ -89,95 +152,142 @@ namespace libmpdataxx
         );
       } 
 
+      template <opts_t opts, class b_t, class psi_t, class flx_t, class G_t>
+      forceinline_macro void beta_dn_loop(
+        b_t &b,
+        const psi_t &psi,
+        const psi_t &psi_min,
+        const flx_t &flx,
+        const G_t &G,
+        const rng_t &ir,  
+        const rng_t &jr
+      )
+      {
+        using ix_t = int;
+        simd::for_each<0>(ir, jr, [&](const int i, const int j)
+        {
+          b(i, j) = 
+          fct_frac<ix_t>(
+            beta_dn_nominator<opts>(psi, psi_min, G, i, j)
+            , // ---------------------------------------------------------
+            ( pospart<opts, ix_t>(flx[0](i+h, j))
+            - negpart<opts, ix_t>(flx[0](i-h, j)) )  //see note in positive sign beta up
+            +
+            ( pospart<opts, ix_t>(flx[1](i, j+h))
+            - negpart<opts, ix_t>(flx[1](i, j-h)) )
+          );
+        });
+      }
+
       template <opts_t opts, class arr_2d_t, class flx_t>
-      forceinline_macro auto beta_dn(
-        arr_2d_t &b, 
-        const arr_2d_t &psi, 
+      forceinline_macro void beta_dn(
+        arr_2d_t &b,
+        const arr_2d_t &psi,
         const arr_2d_t &psi_min, // from before the first iteration
         const flx_t &flx,
-        const arr_2d_t &G, 
-        const rng_t &ir,
+        const arr_2d_t &G,
+        const rng_t &ir,  
         const rng_t &jr
       )
       {
-        using ix_t = int;
-        for (int i = ir.first(); i <= ir.last(); ++i)
+        using real_t = typename arr_2d_t::T_numtype;
+        if (simd::cntg(b, psi, psi_min, flx[0], flx[1]) && simd::cntg_G<opts>(G))
         {
-          for (int j = jr.first(); j <= jr.last(); ++j)
-          {
-            b(i, j) = 
-            fct_frac<ix_t>(
-              beta_dn_nominator<opts>(psi, psi_min, G, i, j)
-              , // ---------------------------------------------------------
-              ( pospart<opts, ix_t>(flx[0](i+h, j))
-              - negpart<opts, ix_t>(flx[0](i-h, j)) )  //see note in positive sign beta up
-              +
-              ( pospart<opts, ix_t>(flx[1](i, j+h))
-              - negpart<opts, ix_t>(flx[1](i, j-h)) )
-            );
-          }
+          simd::cntg_arr_t<real_t, 2> b_c(b);
+          const simd::cntg_arr_t<const real_t, 2> psi_c(psi), psi_min_c(psi_min);
+          beta_dn_loop<opts>(b_c, psi_c, psi_min_c, simd::cntg_vec<const real_t, 2>(flx), simd::G_arr<opts>(G), ir, jr);
         }
+        else beta_dn_loop<opts>(b, psi, psi_min, flx, G, ir, jr);
       } 
 
-      template <opts_t opts, int d, class arr_2d_t>
-      forceinline_macro auto GC_mono( //for variable-sign signal and no infinite gauge option
-        arrvec_t<arr_2d_t> &GC_m,
-        const arr_2d_t &psi,
-        const arr_2d_t &beta_up,
-        const arr_2d_t &beta_dn,
-        const arrvec_t<arr_2d_t> &GC_corr,
-        const arr_2d_t &G,
+      template <opts_t opts, int d, class GC_m_t, class arr_t, class GC_corr_t>
+      forceinline_macro void GC_mono_loop( //for variable-sign signal and no infinite gauge option
+        GC_m_t &GC_m,
+        const arr_t &psi,
+        const arr_t &beta_up,
+        const arr_t &beta_dn,
+        const GC_corr_t &GC_corr,
         const rng_t &ir,
         const rng_t &jr,
         typename std::enable_if<!opts::isset(opts, opts::iga) && opts::isset(opts, opts::abs)>::type* = 0
       )
       {
         using ix_t = int;
-        for (int i = ir.first(); i <= ir.last(); ++i)
+        simd::for_each<d>(ir, jr, [&](const int i, const int j)
         {
-          for (int j = jr.first(); j <= jr.last(); ++j)
-          {
-            GC_m[d]( pi<d>(i+h, j) ) =
-            GC_corr[d]( pi<d>(i+h, j) ) * where<ix_t>(
+          GC_m[d]( pi<d>(i+h, j) ) =
+          GC_corr[d]( pi<d>(i+h, j) ) * where<ix_t>(
+            // if
+            GC_corr[d]( pi<d>(i+h, j) ) > 0,
+            // then
+            where<ix_t>(
               // if
-              GC_corr[d]( pi<d>(i+h, j) ) > 0,
+              psi(pi<d>(i, j)) > 0,
               // then
-              where<ix_t>(
-                // if
-                psi(pi<d>(i, j)) > 0,
-                // then
-                min<ix_t>(1,
-                  beta_dn(pi<d>(i,     j)),
-                  beta_up(pi<d>(i + 1, j)) 
-                ),
-                // else
-                min<ix_t>(1,
-                  beta_up(pi<d>(i,     j)),
-                  beta_dn(pi<d>(i + 1, j))
-                )
+              min<ix_t>(1,
+                beta_dn(pi<d>(i,     j)),
+                beta_up(pi<d>(i + 1, j)) 
               ),
               // else
-              where<ix_t>(
-                // if
-                psi(pi<d>(i+1, j)) > 0,
-                // then
-                min<ix_t>(1,
-                  beta_up(pi<d>(i,     j)),
-                  beta_dn(pi<d>(i + 1, j))
-                ),
-                // else
-                min<ix_t>(1,
-                  beta_dn(pi<d>(i,     j)),
-                  beta_up(pi<d>(i + 1, j))
-                )
+              min<ix_t>(1,
+                beta_up(pi<d>(i,     j)),
+                beta_dn(pi<d>(i + 1, j))
               )
-            );
-          }
-        }
+            ),
+            // else
+            where<ix_t>(
+              // if
+              psi(pi<d>(i+1, j)) > 0,
+              // then
+              min<ix_t>(1,
+                beta_up(pi<d>(i,     j)),
+                beta_dn(pi<d>(i + 1, j))
+              ),
+              // else
+              min<ix_t>(1,
+                beta_dn(pi<d>(i,     j)),
+                beta_up(pi<d>(i + 1, j))
+              )
+            )
+          );
+        });
       } 
 
+      template <opts_t opts, int d, class GC_m_t, class arr_t, class GC_corr_t>
+      forceinline_macro void GC_mono_loop( //for infinite gauge option or positive-sign signal
+        GC_m_t &GC_m,
+        const arr_t &psi,
+        const arr_t &beta_up,
+        const arr_t &beta_dn,
+        const GC_corr_t &GC_corr,
+        const rng_t &ir,
+        const rng_t &jr,
+        typename std::enable_if<opts::isset(opts, opts::iga) || !opts::isset(opts, opts::abs)>::type* = 0
+      )
+      {
+        using ix_t = int;
+        simd::for_each<d>(ir, jr, [&](const int i, const int j)
+        {
+          GC_m[d]( pi<d>(i+h, j) ) =
+          GC_corr[d]( pi<d>(i+h, j) ) * where<ix_t>(
+            // if
+            GC_corr[d]( pi<d>(i+h, j) ) > 0, 
+            // then
+            min<ix_t>(1,
+              beta_dn(pi<d>(i,     j)),
+              beta_up(pi<d>(i + 1, j))
+            ),
+            // else
+            min<ix_t>(1,
+              beta_up(pi<d>(i,     j)),
+              beta_dn(pi<d>(i + 1, j))
+            )
+          );
+        });
+      }
+
       template <opts_t opts, int d, class arr_2d_t>
-      forceinline_macro auto GC_mono( //for infinite gauge option or positive-sign signal
+      forceinline_macro void GC_mono(
         arrvec_t<arr_2d_t> &GC_m,
         const arr_2d_t &psi,
         const arr_2d_t &beta_up,
@@ -185,32 +295,17 @@ namespace libmpdataxx
         const arrvec_t<arr_2d_t> &GC_corr,
         const arr_2d_t &G,
         const rng_t &ir,
-        const rng_t &jr,
-        typename std::enable_if<opts::isset(opts, opts::iga) || !opts::isset(opts, opts::abs)>::type* = 0
+        const rng_t &jr
       )
       {
-        using ix_t = int;
-        for (int i = ir.first(); i <= ir.last(); ++i)
+        using real_t = typename arr_2d_t::T_numtype;
+        if (simd::cntg(GC_m[0], GC_m[1], psi, beta_up, beta_dn, GC_corr[0], GC_corr[1]))
         {
-          for (int j = jr.first(); j <= jr.last(); ++j)
-          {
-            GC_m[d]( pi<d>(i+h, j) ) =
-            GC_corr[d]( pi<d>(i+h, j) ) * where<ix_t>(
-              // if
-              GC_corr[d]( pi<d>(i+h, j) ) > 0, 
-              // then
-              min<ix_t>(1,
-                beta_dn(pi<d>(i,     j)),
-                beta_up(pi<d>(i + 1, j))
-              ),
-              // else
-              min<ix_t>(1,
-                beta_up(pi<d>(i,     j)),
-                beta_dn(pi<d>(i + 1, j))
-              )
-            );
-          }
+          const simd::cntg_arr_t<const real_t, 2> psi_c(psi), beta_up_c(beta_up), beta_dn_c(beta_dn);
+          auto GC_m_c = simd::cntg_vec<real_t, 2>(GC_m);
+          GC_mono_loop<opts, d>(GC_m_c, psi_c, beta_up_c, beta_dn_c, simd::cntg_vec<const real_t, 2>(GC_corr), ir, jr);
         }
+        else GC_mono_loop<opts, d>(GC_m, psi, beta_up, beta_dn, GC_corr, ir, jr);
       }
     } // namespace mpdata_fct
   } // namespace formulae
@@ -197,6 +197,60 @@ namespace libmpdataxx
 	  (v[2](ijk[0], ijk[1], ijk[2]+1) - v[2](ijk[0], ijk[1], ijk[2]-1)) / dijk[2] / 2
         );
       }
+
+      // div(a grad(x)) with the centred differences of div() and grad() combined into
+      // a 5-point (2D) or 7-point (3D) stencil, a[d] being the coefficient of the d-th gradient component
+
+      // 2D version
+      template <int nd, class arr_t, class arrvec_t, class ijk_t, class dijk_t>
+      inline auto lap(
+	const arr_t &x, 
+	const arrvec_t &a, // coefficients
+	const ijk_t &ijk,
+	const dijk_t dijk,
+        typename std::enable_if<nd == 2>::type* = 0
+      ) 
+      {
+        return blitz::safeToReturn(
+	  (
+	    a[0](ijk[0]+1, ijk[1]) * (x(ijk[0]+2, ijk[1]) - x(ijk[0], ijk[1])) - 
+	    a[0](ijk[0]-1, ijk[1]) * (x(ijk[0], ijk[1]) - x(ijk[0]-2, ijk[1]))
+	  ) / dijk[0] / dijk[0] / 4
+	  +
+	  (
+	    a[1](ijk[0], ijk[1]+1) * (x(ijk[0], ijk[1]+2) - x(ijk[0], ijk[1])) - 
+	    a[1](ijk[0], ijk[1]-1) * (x(ijk[0], ijk[1]) - x(ijk[0], ijk[1]-2))
+	  ) / dijk[1] / dijk[1] / 4
+        );
+      }
+      
+      // 3D version
+      template <int nd, class arr_t, class arrvec_t, class ijk_t, class dijk_t>
+      inline auto lap(
+	const arr_t &x, 
+	const arrvec_t &a, // coefficients
+	const ijk_t &ijk,
+	const dijk_t dijk,
+        typename std::enable_if<nd == 3>::type* = 0
+      ) 
+      {
+        return blitz::safeToReturn(
+	  (
+	    a[0](ijk[0]+1, ijk[1], ijk[2]) * (x(ijk[0]+2, ijk[1], ijk[2]) - x(ijk[0], ijk[1], ijk[2])) - 
+	    a[0](ijk[0]-1, ijk[1], ijk[2]) * (x(ijk[0], ijk[1], ijk[2]) - x(ijk[0]-2, ijk[1], ijk[2]))
+	  ) / dijk[0] / dijk[0] / 4
+	  +
+	  (
+	    a[1](ijk[0], ijk[1]+1, ijk[2]) * (x(ijk[0], ijk[1]+2, ijk[2]) - x(ijk[0], ijk[1], ijk[2])) - 
+	    a[1](ijk[0], ijk[1]-1, ijk[2]) * (x(ijk[0], ijk[1], ijk[2]) - x(ijk[0], ijk[1]-2, ijk[2]))
+	  ) / dijk[1] / dijk[1] / 4
+	  +
+	  (
+	    a[2](ijk[0], ijk[1], ijk[2]+1) * (x(ijk[0], ijk[1], ijk[2]+2) - x(ijk[0], ijk[1], ijk[2])) - 
+	    a[2](ijk[0], ijk[1], ijk[2]-1) * (x(ijk[0], ijk[1], ijk[2]) - x(ijk[0], ijk[1], ijk[2]-2))
+	  ) / dijk[2] / dijk[2] / 4
+        );
+      }
     } // namespace nabla_op
   } // namespace formulae
 } // namespace libmpdataxx
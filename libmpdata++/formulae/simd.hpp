@@ -0,0 +1,212 @@
+/** @file
+  * @copyright University of Warsaw
+  * @section LICENSE
+  * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+  *
+  * @brief helpers for point-wise loops to be vectorised by the compiler: the innermost loop runs along
+  *        the last (contiguous in memory) dimension, is marked as free of loop-carried dependencies
+  *        and accesses the arrays through views with the unit stride known at compile time
+  *        (the instruction set, e.g. AVX2 or AVX-512, is the one targeted by the compiler flags;
+  *        with LIBMPDATAXX_NO_SIMD defined, or for arrays not contiguous along the last dimension,
+  *        the same loops are run without the hints on the blitz arrays)
+  */
+
+#pragma once
+
+#include <libmpdata++/blitz.hpp>
+#include <libmpdata++/formulae/idxperm.hpp>
+#include <libmpdata++/opts.hpp>
+
+#include <array>
+#include <cassert>
+#include <utility>
+
+#if defined(LIBMPDATAXX_NO_SIMD)
+#  define LIBMPDATAXX_SIMD_LOOP
+#elif defined(_OPENMP)
+#  define LIBMPDATAXX_SIMD_LOOP _Pragma("omp simd")
+#elif BOOST_COMP_CLANG
+#  define LIBMPDATAXX_SIMD_LOOP _Pragma("clang loop vectorize(enable)")
+#elif BOOST_COMP_GNUC
+#  define LIBMPDATAXX_SIMD_LOOP _Pragma("GCC ivdep")
+#else
+#  define LIBMPDATAXX_SIMD_LOOP
+#endif
+
+namespace libmpdataxx
+{
+  namespace formulae
+  {
+    namespace simd
+    {
+      // view of a blitz array contiguous along the last dimension
+      // (real_t may be const-qualified for read-only access)
+      template <typename real_t, int n_dims>
+      class cntg_arr_t
+      {
+        real_t *zero; // address of the (0, 0, ...) element, possibly outside of the array
+        std::array<int, n_dims> strides;
+
+        public:
+
+        template <class arr_t>
+        explicit cntg_arr_t(arr_t &arr) :
+          zero(arr.dataZero())
+        {
+          for (int d = 0; d < n_dims; ++d) strides[d] = arr.stride(d);
+          assert(strides[n_dims - 1] == 1);
+        }
+
+        forceinline_macro real_t &operator()(const int i) const
+        {
+          return zero[i];
+        }
+
+        forceinline_macro real_t &operator()(const int i, const int j) const
+        {
+          return zero[i * strides[0] + j];
+        }
+
+        forceinline_macro real_t &operator()(const int i, const int j, const int k) const
+        {
+          return zero[i * strides[0] + j * strides[1] + k];
+        }
+
+        forceinline_macro real_t &operator()(const idxperm::int_idx_t<2> &ij) const
+        {
+          return (*this)(ij[0], ij[1]);
+        }
+
+        forceinline_macro real_t &operator()(const idxperm::int_idx_t<3> &ijk) const
+        {
+          return (*this)(ijk[0], ijk[1], ijk[2]);
+        }
+      };
+
+      // views of the arrays in an arrvec_t
+      template <typename real_t, int n_dims, class arrvec_t, std::size_t... ds>
+      std::array<cntg_arr_t<real_t, n_dims>, n_dims> cntg_vec(arrvec_t &av, std::index_sequence<ds...>)
+      {
+        return {{cntg_arr_t<real_t, n_dims>(av[ds])...}};
+      }
+
+      template <typename real_t, int n_dims, class arrvec_t>
+      std::array<cntg_arr_t<real_t, n_dims>, n_dims> cntg_vec(arrvec_t &av)
+      {
+        return cntg_vec<real_t, n_dims>(av, std::make_index_sequence<n_dims>());
+      }
+
+      // true if the vectorised loops may be used with the given arrays
+      template <class arr_t>
+      bool cntg(const arr_t &arr)
+      {
+#if defined(LIBMPDATAXX_NO_SIMD)
+        return false;
+#else
+        return arr.stride(arr_t::rank_ - 1) == 1;
+#endif
+      }
+
+      template <class arr_t, class... arrs_t>
+      bool cntg(const arr_t &arr, const arrs_t &... arrs)
+      {
+        return cntg(arr) && cntg(arrs...);
+      }
+
+      // the G array, accessed only if opts::nug is set
+      template <opts::opts_t opts, class arr_t>
+      bool cntg_G(const arr_t &G)
+      {
+        return !opts::isset(opts, opts::nug) || cntg(G);
+      }
+
+      template <opts::opts_t opts, class arr_t>
+      auto G_arr(const arr_t &G, typename std::enable_if<opts::isset(opts, opts::nug)>::type* = 0)
+      {
+        return cntg_arr_t<const typename arr_t::T_numtype, arr_t::rank_>(G);
+      }
+
+      template <opts::opts_t opts, class arr_t>
+      const arr_t &G_arr(const arr_t &G, typename std::enable_if<!opts::isset(opts, opts::nug)>::type* = 0)
+      {
+        return G;
+      }
+
+      // calls body(i) for each i in ir
+      template <int d, class body_t>
+      forceinline_macro void for_each(const rng_t &ir, const body_t &body, typename std::enable_if<d == 0>::type* = 0)
+      {
+        const int if_ = ir.first(), il = ir.last();
+        LIBMPDATAXX_SIMD_LOOP
+        for (int i = if_; i <= il; ++i) body(i);
+      }
+
+      // calls body(i, j) for each (i, j) in ir x jr, (i, j) being permuted with idxperm::pi<d>,
+      // and with the loops nested so that the innermost one runs along the last dimension
+      template <int d, class body_t>
+      forceinline_macro void for_each(const rng_t &ir, const rng_t &jr, const body_t &body, typename std::enable_if<d == 0>::type* = 0)
+      {
+        const int jf = jr.first(), jl = jr.last();
+        for (int i = ir.first(); i <= ir.last(); ++i)
+        {
+          LIBMPDATAXX_SIMD_LOOP
+          for (int j = jf; j <= jl; ++j) body(i, j);
+        }
+      }
+
+      template <int d, class body_t>
+      forceinline_macro void for_each(const rng_t &ir, const rng_t &jr, const body_t &body, typename std::enable_if<d == 1>::type* = 0)
+      {
+        const int if_ = ir.first(), il = ir.last();
+        for (int j = jr.first(); j <= jr.last(); ++j)
+        {
+          LIBMPDATAXX_SIMD_LOOP
+          for (int i = if_; i <= il; ++i) body(i, j);
+        }
+      }
+
+      // 3D version of the above
+      template <int d, class body_t>
+      forceinline_macro void for_each(const rng_t &ir, const rng_t &jr, const rng_t &kr, const body_t &body, typename std::enable_if<d == 0>::type* = 0)
+      {
+        const int kf = kr.first(), kl = kr.last();
+        for (int i = ir.first(); i <= ir.last(); ++i)
+        {
+          for (int j = jr.first(); j <= jr.last(); ++j)
+          {
+            LIBMPDATAXX_SIMD_LOOP
+            for (int k = kf; k <= kl; ++k) body(i, j, k);
+          }
+        }
+      }
+
+      template <int d, class body_t>
+      forceinline_macro void for_each(const rng_t &ir, const rng_t &jr, const rng_t &kr, const body_t &body, typename std::enable_if<d == 1>::type* = 0)
+      {
+        const int jf = jr.first(), jl = jr.last();
+        for (int k = kr.first(); k <= kr.last(); ++k)
+        {
+          for (int i = ir.first(); i <= ir.last(); ++i)
+          {
+            LIBMPDATAXX_SIMD_LOOP
+            for (int j = jf; j <= jl; ++j) body(i, j, k);
+          }
+        }
+      }
+
+      template <int d, class body_t>
+      forceinline_macro void for_each(const rng_t &ir, const rng_t &jr, const rng_t &kr, const body_t &body, typename std::enable_if<d == 2>::type* = 0)
+      {
+        const int if_ = ir.first(), il = ir.last();
+        for (int j = jr.first(); j <= jr.last(); ++j)
+        {
+          for (int k = kr.first(); k <= kr.last(); ++k)
+          {
+            LIBMPDATAXX_SIMD_LOOP
+            for (int i = if_; i <= il; ++i) body(i, j, k);
+          }
+        }
+      }
+    } // namespace simd
+  } // namespace formulae
+} // namespace libmpdataxx
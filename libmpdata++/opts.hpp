@@ -45,7 +45,11 @@ namespace libmpdataxx
       div_2nd = opts::bit(9),  // second-order MPDATA in divergence form
       div_3rd = opts::bit(10), // third-order correction in divergence form
       div_3rd_dt = opts::bit(11), // third-order correction in divergence form utilising first time derivative
-      fot = opts::bit(12)  // fourth-order terms
+      fot = opts::bit(12), // fourth-order terms
+      mpr = opts::bit(13)  // mixed precision (partial): only the point-wise flux and donor-cell kernels compute in 
+                           // (at least) double precision, their results are rounded back to real_t; all arrays 
+                           // (state, advector, temporaries) are stored in real_t and the antidiffusive velocities, 
+                           // fct, sums and reductions compute in real_t (i.e. no separate storage and compute types)
     };
 
     const std::map<decltype(fct), std::string> opt2name {
@@ -60,13 +64,14 @@ namespace libmpdataxx
       {khn, "khn"},
       {div_2nd, "div_2nd"},
       {div_3rd, "div_3rd"},
-      {fot, "fot"}
+      {fot, "fot"},
+      {mpr, "mpr"}
     };
 
     inline std::string opts_string(opts_t opts)
     {
       std::string ret;
-      const auto opt_order = {nug, iga, abs, dfl, div_2nd, tot, div_3rd, fot, fct, pfc, npa, khn};
+      const auto opt_order = {nug, iga, abs, dfl, div_2nd, tot, div_3rd, fot, fct, pfc, npa, khn, mpr};
       for (const auto &o : opt_order)
       {
         if (isset(opts, o))
@@ -83,6 +88,11 @@ namespace libmpdataxx
     enum { opts = opts::iga | opts::fct };
     enum { hint_norhs = 0 };
     enum { delayed_step = 0 };
+    enum { eqn_pipeline = false }; // if true, advection temporaries are allocated for each equation
+                                   // and threads do not wait for each other between equations
+    enum { fused_eqns = false };   // if true, equations sharing the advector are advected together, 
+                                   // tile by tile (see LIBMPDATAXX_TILE_BYTES) in 2D and 3D
+                                   // without fct (otherwise one after another)
     struct ix {};
     static constexpr int hint_scale(const int &e) { return 0; } // base-2 logarithm
     enum { var_dt = false};
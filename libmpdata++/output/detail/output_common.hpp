@@ -48,6 +48,10 @@ namespace libmpdataxx
 	{
 	  parent_t::hook_ante_loop(nt);
 
+          // each process would write just its part of the domain to the same place
+          if (this->mem->distmem.size() > 1)
+            throw std::runtime_error("output not supported with multiple MPI processes");
+
           if (this->var_dt)
           {
             for (const auto &v : outvars)
@@ -93,8 +93,9 @@ namespace libmpdataxx
           // would lead to double multiplications
           // TODO: better way ?
           auto ijkm_aux = this->ijkm;
-          if (this->rank > 0)
-            ijkm_aux[0] = this->ijk[0];
+          for (int d = 0; d < ct_params_t::n_dims; ++d)
+            if (!this->left_edge(d))
+              ijkm_aux[d] = this->ijk[d];
 
           formulae::stress::multiply_tnsr_cmpct<ct_params_t::n_dims, ct_params_t::opts>(this->tau,
                                                                                         real_t(1.0),
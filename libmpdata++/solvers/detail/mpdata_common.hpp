@@ -6,6 +6,12 @@
 
 #pragma once
 
+// size of the advector components in a single tile of the fused advection
+// of multiple equations (see ct_params_t::fused_eqns), ideally fitting the L2 cache
+#if !defined(LIBMPDATAXX_TILE_BYTES)
+#  define LIBMPDATAXX_TILE_BYTES (256 * 1024)
+#endif
+
 namespace libmpdataxx
 {
   namespace solvers
@@ -34,7 +40,7 @@ namespace libmpdataxx
 
 	// member fields
 	std::vector<GC_t*> tmp;
-        GC_t &flux, *flux_ptr;
+        GC_t flux, *flux_ptr; // flux holds views of the arrays in mem->tmp (see eqn_tmp())
 
         // methods
 	GC_t &GC_unco(int iter)
@@ -59,6 +65,36 @@ namespace libmpdataxx
 	  return GC_corr(iter);
 	}
 
+        // exchange of the advectees of several equations within a single set of barriers
+        void xchng_eqns(const std::vector<int> &eqns)
+        {
+          arrvec_t<typename parent_t::arr_t> psis;
+          for (const int &e : eqns)
+          {
+            auto &psi = this->mem->psi[e][this->n[e]];
+            if (this->halo_valid(psi, this->halo)) continue;
+            psis.resize(psis.size() + 1);
+            psis.replace(psis.end() - 1, this->mem->never_delete(&psi));
+          }
+          if (psis.empty()) return;
+          this->xchng_sclr(psis, this->ijk, this->halo);
+          for (const int &e : eqns) this->mem->halo_validate(this->rank, this->mem->psi[e][this->n[e]], this->halo);
+        }
+
+        // partition of the subdomain along the first dimension into tiles of whole rows
+        // with the advector components within a tile not exceeding LIBMPDATAXX_TILE_BYTES
+        std::vector<rng_t> tiles() const
+        {
+          std::size_t row = parent_t::n_dims * sizeof(typename ct_params_t::real_t);
+          for (int d = 1; d < parent_t::n_dims; ++d) row *= this->ijk[d].length() + 2 * this->halo;
+          const int len = std::max<int>(1, LIBMPDATAXX_TILE_BYTES / row);
+
+          std::vector<rng_t> ret;
+          for (int first = this->ijk.lbound(0); first <= this->ijk.ubound(0); first += len)
+            ret.push_back(rng_t(first, std::min(first + len - 1, this->ijk.ubound(0))));
+          return ret;
+        }
+
 	// for Flux-Corrected Transport 
 	virtual void fct_init(int e) { }
 	virtual void fct_adjust_antidiff(int e, int iter) { }
@@ -69,12 +105,41 @@ namespace libmpdataxx
           return n_iters > 2 ? 2 : 1; 
         }
 
+        // number of sets of temporaries (see ct_params_t::eqn_pipeline and ct_params_t::fused_eqns)
+        static constexpr int n_sets()
+        {
+          return ct_params_t::eqn_pipeline || ct_params_t::fused_eqns ? ct_params_t::n_eqns : 1;
+        }
+
+        // fluxes of a given equation (as opposed to the flux member that views those of the current one)
+        GC_t &eqn_flux(const int e)
+        {
+          if (n_sets() == 1) return flux;
+          return this->mem->tmp[__FILE__][e * (n_tmp(n_iters) + 1) + n_tmp(n_iters)];
+        }
+
+        // to be called at the beginning of advop(e): with ct_params_t::eqn_pipeline (or fused_eqns)
+        // each equation uses a set of temporaries of its own, so that no thread
+        // overwrites them while others still work on the previous equation
+        virtual void eqn_tmp(const int e)
+        {
+          if (n_sets() == 1) return;
+          auto &sets = this->mem->tmp[__FILE__];
+          const int n = n_tmp(n_iters) + 1; // per equation, incl. fluxes
+	  for (int t = 0; t < n_tmp(n_iters); ++t)
+	    tmp[t] = &sets[e * n + t];
+          for (int d = 0; d < ct_params_t::n_dims; ++d)
+            flux[d].reference(sets[e * n + n - 1][d]);
+        }
+
         public:
 
 	struct rt_params_t : parent_t::rt_params_t
         {
           int n_iters = 2; 
           int upwind_filter_freq = 0; 
+          bool tiled = false; // 3D only, see mpdata_osc_3d::advop_tiled()
+          bool single_pass = false; // 2D & 3D only, see mpdata_osc_2d::advop_single_pass()
         };
 
         protected:
@@ -104,9 +169,12 @@ namespace libmpdataxx
           const int &n_iters
         ) {   
 	  parent_t::alloc(mem, n_iters);
-	  for (int n = 0; n < n_tmp(n_iters); ++n)
-	    parent_t::alloc_tmp_vctr(mem, __FILE__);
-          parent_t::alloc_tmp_vctr(mem, __FILE__); // fluxes
+          for (int e = 0; e < n_sets(); ++e)
+          {
+	    for (int n = 0; n < n_tmp(n_iters); ++n)
+	      parent_t::alloc_tmp_vctr(mem, __FILE__);
+            parent_t::alloc_tmp_vctr(mem, __FILE__); // fluxes
+          }
 	}   
       };
 
@@ -33,16 +33,7 @@ namespace libmpdataxx
 	  const auto i1 = this->i^1, j1 = this->j^1; // not optimal - with multiple threads some indices are repeated among threads
 	  const auto psi = this->mem->psi[e][this->n[e]]; 
 
-	  this->psi_min(i1,j1) = min(min(min(min(
-			   psi(i1,j1+1),
-	    psi(i1-1,j1)), psi(i1,j1  )), psi(i1+1,j1)),
-			   psi(i1,j1-1)
-	  );
-	  this->psi_max(i1,j1) = max(max(max(max(
-			   psi(i1,j1+1),
-	    psi(i1-1,j1)), psi(i1,j1  )), psi(i1+1,j1)), 
-			   psi(i1,j1-1)
-	  ); 
+	  formulae::mpdata::psi_min_max(this->psi_min, this->psi_max, psi, i1, j1);
 	}
 
 	void fct_adjust_antidiff(int e, int iter)
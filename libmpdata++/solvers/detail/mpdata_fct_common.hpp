@@ -35,6 +35,19 @@ namespace libmpdataxx
 	  return parent_t::GC(iter);
 	}
 
+        void eqn_tmp(const int e)
+        {
+          parent_t::eqn_tmp(e);
+          if (parent_t::n_sets() == 1) return;
+          auto &sets = this->mem->tmp[__FILE__];
+          psi_min.reference(sets[3 * e][0]);
+          psi_max.reference(sets[3 * e][1]);
+          for (int d = 0; d < ct_params_t::n_dims; ++d) 
+            GC_mono[d].reference(sets[3 * e + 1][d]);
+          beta_up.reference(sets[3 * e + 2][0]);
+          beta_dn.reference(sets[3 * e + 2][1]);
+        }
+
         void beta_barrier(const int &iter)
         {
 	  if (!opts::isset(ct_params_t::opts, opts::iga)) // this->flux would be overwritten by donor-cell
@@ -61,9 +74,12 @@ namespace libmpdataxx
           const int &n_iters
         ) {
 	  parent_t::alloc(mem, n_iters);
-	  parent_t::alloc_tmp_sclr(mem, __FILE__, 2); // psi_min and psi_max
-	  parent_t::alloc_tmp_vctr(mem, __FILE__);    // GC_mono
-	  parent_t::alloc_tmp_sclr(mem, __FILE__, 2); // beta_up, beta_dn
+          for (int e = 0; e < parent_t::n_sets(); ++e)
+          {
+	    parent_t::alloc_tmp_sclr(mem, __FILE__, 2); // psi_min and psi_max
+	    parent_t::alloc_tmp_vctr(mem, __FILE__);    // GC_mono
+	    parent_t::alloc_tmp_sclr(mem, __FILE__, 2); // beta_up, beta_dn
+          }
 	}
       };
 
@@ -32,7 +32,13 @@ namespace libmpdataxx
 
 	protected:
 
-	const rng_t im;
+	rng_t im;
+
+        void set_subdomain(const idx_t<1> &ijk_new)
+        {
+          parent_t::set_subdomain(ijk_new);
+          im = rng_t(this->i.first() - 1, this->i.last());
+        }
 
 	void hook_ante_loop(const typename parent_t::advance_arg_t nt)
 	{
@@ -57,6 +63,7 @@ namespace libmpdataxx
 	// method invoked by the solver
 	void advop(int e)
 	{
+	  this->eqn_tmp(e);
 	  this->fct_init(e); // e.g. store psi_min, psi_max in FCT
 
 	  for (int iter = 0; iter < this->n_iters; ++iter) 
@@ -94,7 +101,8 @@ namespace libmpdataxx
 	    // calculation of fluxes
 	    if (!opts::isset(ct_params_t::opts, opts::iga) || iter == 0)
 	    {
-              this->flux[0](im+h) = formulae::donorcell::make_flux<ct_params_t::opts>(
+              formulae::donorcell::calc_flux<ct_params_t::opts>(
+                this->flux[0],
                 this->mem->psi[e][this->n[e]],
                 this->GC(iter)[0], 
                 im
@@ -112,14 +120,12 @@ namespace libmpdataxx
             //assert(std::isfinite(sum(flux_ref[0](i^h))));
 
 	    // donor-cell call // TODO: could be made common for 1D/2D/3D
-            formulae::donorcell::donorcell_sum<ct_params_t::opts>(
-              this->mem->khn_tmp,
-              this->ijk,
-              this->mem->psi[e][this->n[e]+1](this->ijk),
-              this->mem->psi[e][this->n[e]  ](this->ijk),
-              (*(this->flux_ptr))[0](this->i+h),
-              (*(this->flux_ptr))[0](this->i-h),
-              formulae::G<ct_params_t::opts>(*this->mem->G, this->i)
+            formulae::donorcell::donorcell<ct_params_t::opts>(
+              this->mem->psi[e][this->n[e]+1],
+              this->mem->psi[e][this->n[e]  ],
+              *(this->flux_ptr),
+              *this->mem->G,
+              this->i
             );
 
             if (this->upwind_filter_freq > 0 && this->timestep % this->upwind_filter_freq == 0)
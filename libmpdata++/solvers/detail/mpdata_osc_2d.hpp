@@ -35,7 +35,17 @@ namespace libmpdataxx
 	protected:
 
 	// member fields
-	const rng_t im, jm;
+	rng_t im, jm;
+
+        // see advop_single_pass()
+        const bool single_pass;
+
+        void set_subdomain(const idx_t<2> &ijk_new)
+        {
+          parent_t::set_subdomain(ijk_new);
+          im = rng_t(this->i.first() - 1, this->i.last());
+          jm = rng_t(this->j.first() - 1, this->j.last());
+        }
 
 	void hook_ante_loop(const typename parent_t::advance_arg_t nt)
 	{   
@@ -66,13 +76,85 @@ namespace libmpdataxx
           }
 	} 
 
+        // true if a given iteration is done by advop_single_pass(): the last corrective one (the antidiffusive
+        // velocities of the others are needed in full by the subsequent iteration) unless fct or iga
+        // is used (which need the antidiffusive velocities or fluxes stored) or the divergence form
+        // of the antidiffusive velocity
+        bool single_pass_iter(const int iter) const
+        {
+          return single_pass &&
+            !opts::isset(ct_params_t::opts, opts::fct) &&
+            !opts::isset(ct_params_t::opts, opts::iga) &&
+            !opts::isset(ct_params_t::opts, opts::div_2nd) &&
+            !opts::isset(ct_params_t::opts, opts::div_3rd) &&
+            iter != 0 && iter == this->n_iters - 1;
+        }
+
+        // a corrective iteration done in a single pass (see rt_params_t::single_pass): for each cell
+        // the antidiffusive velocities and the fluxes at its faces are computed on the fly and summed
+        // up right away, hence neither are stored nor exchanged (at the cost of computing them twice 
+        // per face); the zero-flux conditions at domain edges (see bcond_common::mirror_flux()) are 
+        // applied within the loop
+        void advop_single_pass(const int e, const int iter)
+        {
+          this->cycle(e);
+          this->xchng(e);
+
+          using cm_t = formulae::cmpt_t<ct_params_t::opts, typename ct_params_t::real_t>;
+          const auto &psi(this->mem->psi[e][this->n[e]]);
+          auto &psi_new(this->mem->psi[e][this->n[e]+1]);
+          const auto &GC(this->GC_unco(iter));
+          const auto &G(*this->mem->G);
+
+          // cells adjacent to the edges with the zero-flux condition (the ones before the first are never reached)
+          const int 
+            il = this->mirror_flux(0, false) ? this->i.first() : this->i.first() - 1,
+            ir = this->mirror_flux(0, true)  ? this->i.last()  : this->i.first() - 1,
+            jl = this->mirror_flux(1, false) ? this->j.first() : this->j.first() - 1,
+            jr = this->mirror_flux(1, true)  ? this->j.last()  : this->j.first() - 1;
+
+          // fluxes through the (i+1/2, j) and (i, j+1/2) faces
+          auto flx_x = [&](const int i, const int j) -> cm_t
+          {
+            return formulae::donorcell::F_pt<ct_params_t::opts>(cm_t(psi(i, j)), cm_t(psi(i+1, j)), 
+              cm_t(formulae::mpdata::antidiff_pt<ct_params_t::opts, 0>(psi, GC, G, i, j))
+            );
+          };
+          auto flx_y = [&](const int i, const int j) -> cm_t
+          {
+            return formulae::donorcell::F_pt<ct_params_t::opts>(cm_t(psi(i, j)), cm_t(psi(i, j+1)), 
+              cm_t(formulae::mpdata::antidiff_pt<ct_params_t::opts, 1>(psi, GC, G, j, i))
+            );
+          };
+
+          formulae::simd::for_each<0>(this->i, this->j, [&](const int i, const int j)
+          {
+            const cm_t
+              fx_l = flx_x(i-1, j), fx_r = flx_x(i, j),
+              fy_l = flx_y(i, j-1), fy_r = flx_y(i, j);
+            psi_new(i, j) = formulae::donorcell::donorcell_pt<ct_params_t::opts>(
+              cm_t(psi(i, j)),
+              i == ir ? -fx_l : fx_r, i == il ? -fx_r : fx_l,
+              j == jr ? -fy_l : fy_r, j == jl ? -fy_r : fy_l,
+              formulae::G<ct_params_t::opts, 0>(G, i, j)
+            );
+          });
+        }
+
 	// method invoked by the solver
 	void advop(int e)
 	{
+	  this->eqn_tmp(e);
 	  this->fct_init(e);
 
 	  for (int iter = 0; iter < this->n_iters; ++iter) 
 	  {
+            if (single_pass_iter(iter))
+            {
+              advop_single_pass(e, iter);
+              continue;
+            }
+
 	    if (iter != 0)
 	    {
 	      this->cycle(e);
@@ -133,12 +215,14 @@ namespace libmpdataxx
             // calculation of fluxes
             if (!opts::isset(ct_params_t::opts, opts::iga) || iter == 0)
             {
-              this->flux[0](im+h, this->j) = formulae::donorcell::make_flux<ct_params_t::opts, 0>(
+              formulae::donorcell::calc_flux<ct_params_t::opts, 0>(
+                this->flux[0],
                 this->mem->psi[e][this->n[e]], 
                 this->GC(iter)[0], 
                 im, this->j
               );
-              this->flux[1](this->i, jm+h) = formulae::donorcell::make_flux<ct_params_t::opts, 1>(
+              formulae::donorcell::calc_flux<ct_params_t::opts, 1>(
+                this->flux[1],
                 this->mem->psi[e][this->n[e]], 
                 this->GC(iter)[1], 
                 jm, this->i
@@ -161,16 +245,12 @@ namespace libmpdataxx
 
 	    // donor-cell call 
 	    // TODO: doing antidiff,upstream,antidiff,upstream (for each dimension separately) could help optimise memory consumption!
-	    formulae::donorcell::donorcell_sum<ct_params_t::opts>(
-	      this->mem->khn_tmp,
-              this->ijk,
-	      this->mem->psi[e][this->n[e]+1](this->ijk), 
-	      this->mem->psi[e][this->n[e]  ](this->ijk), 
-              flx[0](this->i+h, this->j  ),
-              flx[0](this->i-h, this->j  ),
-              flx[1](this->i,   this->j+h),
-              flx[1](this->i,   this->j-h),
-              formulae::G<ct_params_t::opts, 0>(*this->mem->G, this->i, this->j)
+	    formulae::donorcell::donorcell<ct_params_t::opts>(
+	      this->mem->psi[e][this->n[e]+1], 
+	      this->mem->psi[e][this->n[e]  ], 
+              flx,
+              *this->mem->G,
+              this->i, this->j
 	    ); 
 
             if (this->upwind_filter_freq > 0 && this->timestep % this->upwind_filter_freq == 0)
@@ -182,6 +262,141 @@ namespace libmpdataxx
 	  }
 	}
 
+        // advection of several equations sharing the advector done tile by tile (see mpdata_common::tiles()),
+        // so that the advector components of a tile are brought to cache once for all the equations;
+        // gives the same results as advop() called for each equation (which is used if fct is set)
+        void advop_fused(const std::vector<int> &eqns)
+        {
+          if (opts::isset(ct_params_t::opts, opts::fct)) 
+          {
+            parent_t::advop_fused(eqns);
+            return;
+          }
+
+          const auto &j(this->j);
+          const auto tiles = this->tiles();
+
+          this->xchng_eqns(eqns);
+
+	  for (int iter = 0; iter < this->n_iters; ++iter) 
+	  {
+	    if (iter != 0)
+	    {
+              for (const int &e : eqns) this->cycle(e);
+              this->xchng_eqns(eqns);
+
+	      // calculating the antidiffusive C 
+              for (const auto &ti : tiles)
+              {
+                const rng_t tim(ti.first() - 1, ti.last());
+                for (const int &e : eqns)
+                {
+                  this->eqn_tmp(e);
+                  formulae::mpdata::antidiff<ct_params_t::opts, 0,
+                                             static_cast<sptl_intrp_t>(ct_params_t::sptl_intrp),
+                                             static_cast<tmprl_extrp_t>(ct_params_t::tmprl_extrp)>(
+                    this->GC_corr(iter)[0],
+                    this->mem->psi[e][this->n[e]], 
+                    this->mem->psi[e][this->n[e]-1],
+                    this->GC_unco(iter),
+                    this->mem->ndt_GC,
+                    this->mem->ndtt_GC,
+                    *this->mem->G,
+                    tim, 
+                    j
+                  );
+                  formulae::mpdata::antidiff<ct_params_t::opts, 1,
+                                             static_cast<sptl_intrp_t>(ct_params_t::sptl_intrp),
+                                             static_cast<tmprl_extrp_t>(ct_params_t::tmprl_extrp)>(
+                    this->GC_corr(iter)[1],
+                    this->mem->psi[e][this->n[e]], 
+                    this->mem->psi[e][this->n[e]-1],
+                    this->GC_unco(iter),
+                    this->mem->ndt_GC,
+                    this->mem->ndtt_GC,
+                    *this->mem->G,
+                    jm, 
+                    ti
+                  );
+                }
+              }
+
+              if (opts::isset(ct_params_t::opts, opts::div_3rd_dt))
+                this->mem->barrier();
+
+              if (iter != (this->n_iters - 1))
+              {
+                for (const int &e : eqns)
+                {
+                  this->eqn_tmp(e);
+                  this->xchng_vctr_nrml(this->GC_corr(iter), this->ijk);
+                  if (opts::isset(ct_params_t::opts, opts::dfl)) this->xchng_vctr_alng(this->GC_corr(iter));
+                }
+              }
+	    }
+
+            // calculation of fluxes
+            std::vector<arrvec_t<typename parent_t::arr_t>*> flxs;
+            if (!opts::isset(ct_params_t::opts, opts::iga) || iter == 0)
+            {
+              for (const auto &ti : tiles)
+              {
+                const rng_t tim(ti.first() - 1, ti.last());
+                for (const int &e : eqns)
+                {
+                  this->eqn_tmp(e);
+                  formulae::donorcell::calc_flux<ct_params_t::opts, 0>(
+                    this->flux[0],
+                    this->mem->psi[e][this->n[e]], 
+                    this->GC(iter)[0], 
+                    tim, j
+                  );
+                  formulae::donorcell::calc_flux<ct_params_t::opts, 1>(
+                    this->flux[1],
+                    this->mem->psi[e][this->n[e]], 
+                    this->GC(iter)[1], 
+                    jm, ti
+                  );
+                }
+              }
+              for (const int &e : eqns) flxs.push_back(&this->eqn_flux(e));
+            }
+            else
+            {   
+              assert(iter == 1); // infinite gauge option uses just one corrective step
+              for (const int &e : eqns) 
+              {
+                this->eqn_tmp(e);
+                flxs.push_back(&this->GC(iter));
+              }
+            }   
+
+            this->xchng_flux(flxs);
+
+	    // donor-cell call 
+            for (const auto &ti : tiles)
+            {
+              for (int f = 0; f < int(eqns.size()); ++f)
+              {
+                const int &e = eqns[f];
+                const auto &flx = *flxs[f];
+	        formulae::donorcell::donorcell<ct_params_t::opts>(
+	          this->mem->psi[e][this->n[e]+1], 
+	          this->mem->psi[e][this->n[e]  ], 
+                  flx,
+                  *this->mem->G,
+                  ti, j
+	        ); 
+              }
+            }
+
+            if (this->upwind_filter_freq > 0 && this->timestep % this->upwind_filter_freq == 0)
+            {
+              break;
+            }
+	  }
+        }
+
         // performs advection of a given field using the donorcell scheme
         // and stores the result in the same field
         // useful for advecting right-hand-sides etc
@@ -231,7 +446,8 @@ namespace libmpdataxx
 	) : 
 	  parent_t(args, p),
 	  im(args.i.first() - 1, args.i.last()),
-	  jm(args.j.first() - 1, args.j.last())
+	  jm(args.j.first() - 1, args.j.last()),
+          single_pass(p.single_pass)
 	{ }
       };
     } // namespace detail
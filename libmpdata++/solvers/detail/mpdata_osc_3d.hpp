@@ -7,6 +7,7 @@
 #pragma once
 
 #include <array>
+#include <vector>
 
 #include <libmpdata++/formulae/mpdata/formulae_mpdata_common.hpp>  //TODO tmp
 
@@ -35,8 +36,104 @@ namespace libmpdataxx
 	protected:
 
 	// member fields
-	const rng_t im, jm, km;
+	rng_t im, jm, km;
+
+        // regions for each vector component: the whole subdomain, its interior in which 
+        // the stencils do not reach the halos (empty if the subdomain is too thin or if 
+        // there is no other subdomain to overlap with) and the remaining shell
+        using box_t = std::array<rng_t, 3>;
+        std::array<std::vector<box_t>, 3> full, intr, shll;
+
+        // per-thread buffers for the antidiffusive velocities and fluxes of a single tile
+        // of x-rows (see advop_tiled()), with the tiles of the current subdomain
+        const bool tiled;
+        arrvec_t<typename parent_t::arr_t> tile_GC, tile_flux;
+        std::vector<rng_t> tile_rngs;
+
+        // see advop_single_pass()
+        const bool single_pass;
+
+        // boxes covering the outer box minus the inner one
+        static std::vector<box_t> shell(box_t outer, const box_t &inner)
+        {
+          std::vector<box_t> ret;
+          for (int d = 0; d < 3; ++d)
+          {
+            if (inner[d].first() > outer[d].first())
+            {
+              ret.push_back(outer);
+              ret.back()[d] = rng_t(outer[d].first(), inner[d].first() - 1);
+            }
+            if (inner[d].last() < outer[d].last())
+            {
+              ret.push_back(outer);
+              ret.back()[d] = rng_t(inner[d].last() + 1, outer[d].last());
+            }
+            outer[d] = inner[d];
+          }
+          return ret;
+        }
   
+        // (re)computes the full, intr and shll boxes for the current subdomain
+        void set_boxes()
+        {
+          for (int d = 0; d < 3; ++d)
+          {
+            full[d].clear();
+            intr[d].clear();
+            shll[d].clear();
+          }
+
+          const box_t ijk_box = {this->i, this->j, this->k}, ijkm_box = {im, jm, km};
+          const int hl = parent_t::halo;
+          bool thick = this->mem->size > 1;
+          box_t ijk_intr;
+          for (int d = 0; d < 3; ++d) 
+          {
+            thick = thick && ijk_box[d].length() > 2 * hl;
+            if (thick) ijk_intr[d] = rng_t(ijk_box[d].first() + hl, ijk_box[d].last() - hl);
+          }
+
+          for (int d = 0; d < 3; ++d)
+          {
+            box_t outer = ijk_box;
+            outer[d] = ijkm_box[d];
+            full[d].push_back(outer);
+            if (!thick) continue;
+            box_t inner = ijk_intr;
+            inner[d] = rng_t(ijk_intr[d].first() - 1, ijk_intr[d].last());
+            intr[d].push_back(inner);
+            shll[d] = shell(outer, inner);
+          }
+        }
+
+        // (re)allocates the tile buffers for the current subdomain
+        void set_tiles()
+        {
+          if (!tiled) return;
+          tile_rngs = this->tiles();
+          int len = 0;
+          for (const auto &ti : tile_rngs) len = std::max(len, ti.length());
+
+          for (auto *av : {&tile_GC, &tile_flux})
+          {
+            av->clear();
+            av->push_back(new typename parent_t::arr_t(rng_t(0, len), this->j, this->k));
+            av->push_back(new typename parent_t::arr_t(rng_t(0, len - 1), jm, this->k));
+            av->push_back(new typename parent_t::arr_t(rng_t(0, len - 1), this->j, km));
+          }
+        }
+
+        void set_subdomain(const idx_t<3> &ijk_new)
+        {
+          parent_t::set_subdomain(ijk_new);
+          im = rng_t(this->i.first() - 1, this->i.last());
+          jm = rng_t(this->j.first() - 1, this->j.last());
+          km = rng_t(this->k.first() - 1, this->k.last());
+          set_boxes();
+          set_tiles();
+        }
+
 	void hook_ante_loop(const typename parent_t::advance_arg_t nt)
 	{   
   //  note that it's not needed for upstream
@@ -69,63 +166,241 @@ namespace libmpdataxx
           }
 	} 
 
+        // antidiffusive velocity component d in a box (x, y and z ranges, the range in d being that of im)
+        template <int d>
+        void antidiff_box(arrvec_t<typename parent_t::arr_t> &GC_corr, const int e, const int iter, const box_t &b)
+        {
+          formulae::mpdata::antidiff<ct_params_t::opts, d,
+                                     static_cast<sptl_intrp_t>(ct_params_t::sptl_intrp),
+                                     static_cast<tmprl_extrp_t>(ct_params_t::tmprl_extrp)>(
+            GC_corr[d],
+            this->mem->psi[e][this->n[e]], 
+            this->mem->psi[e][this->n[e]-1],
+            this->GC_unco(iter),
+            this->mem->ndt_GC,
+            this->mem->ndtt_GC,
+            *this->mem->G,
+            b[d],
+            b[(d + 1) % 3],
+            b[(d + 2) % 3]
+          );
+        }
+
+        void antidiff_boxes(const int e, const int iter, const std::array<std::vector<box_t>, 3> &boxes)
+        {
+          auto &GC_corr(this->GC_corr(iter));
+          for (const auto &b : boxes[0]) antidiff_box<0>(GC_corr, e, iter, b);
+          for (const auto &b : boxes[1]) antidiff_box<1>(GC_corr, e, iter, b);
+          for (const auto &b : boxes[2]) antidiff_box<2>(GC_corr, e, iter, b);
+        }
+
+        // flux component d in a box (as above)
+        template <int d>
+        void flux_box(
+          arrvec_t<typename parent_t::arr_t> &flx, 
+          const typename parent_t::arr_t &psi, 
+          const typename parent_t::arr_t &GC, 
+          const box_t &b
+        )
+        {
+          formulae::donorcell::calc_flux<ct_params_t::opts, d>(flx[d], psi, GC, b[d], b[(d + 1) % 3], b[(d + 2) % 3]);
+        }
+
+        void flux_boxes(const int e, const int iter, const std::array<std::vector<box_t>, 3> &boxes)
+        {
+          const auto &psi(this->mem->psi[e][this->n[e]]);
+          auto &GC(this->GC(iter));
+          for (const auto &b : boxes[0]) flux_box<0>(this->flux, psi, GC[0], b);
+          for (const auto &b : boxes[1]) flux_box<1>(this->flux, psi, GC[1], b);
+          for (const auto &b : boxes[2]) flux_box<2>(this->flux, psi, GC[2], b);
+        }
+
+        // true if a given iteration is done by advop_tiled(): the donor-cell one and the last corrective one,
+        // as the antidiffusive velocities of the others are needed in full by the subsequent iteration
+        // (also by fct and by the temporal terms of div_3rd_dt, with which the tiled mode is not used)
+        bool tiled_iter(const int iter) const
+        {
+          return tiled && 
+            !opts::isset(ct_params_t::opts, opts::fct) && 
+            !opts::isset(ct_params_t::opts, opts::div_3rd_dt) &&
+            (iter == 0 || iter == this->n_iters - 1);
+        }
+
+        // a single iteration done tile by tile (see rt_params_t::tiled): for each tile the antidiffusive 
+        // velocities (if iter != 0), the fluxes and the donor-cell sum are computed one after another
+        // while the tile is in cache, with the former two stored in the per-thread tile buffers;
+        // the fluxes at subdomain edges are computed by both neighbours hence no flux exchange is needed
+        // apart from the zero-flux conditions at domain edges (applied to the tiles touching them)
+        void advop_tiled(const int e, const int iter)
+        {
+          if (iter != 0)
+          {
+            this->cycle(e);
+            this->xchng(e);
+          }
+
+          const auto &j(this->j), &k(this->k);
+          auto &psi(this->mem->psi[e]);
+          const auto &n(this->n[e]);
+          const bool iga = opts::isset(ct_params_t::opts, opts::iga);
+
+          for (const auto &ti : tile_rngs)
+          {
+            const box_t b[3] = {{rng_t(ti.first() - 1, ti.last()), j, k}, {ti, jm, k}, {ti, j, km}};
+            for (int d = 0; d < 3; ++d)
+            {
+              const blitz::TinyVector<int, 3> base(b[d][0].first(), b[d][1].first(), b[d][2].first());
+              tile_GC[d].reindexSelf(base);
+              tile_flux[d].reindexSelf(base);
+            }
+
+            if (iter != 0)
+            {
+              antidiff_box<0>(tile_GC, e, iter, b[0]);
+              antidiff_box<1>(tile_GC, e, iter, b[1]);
+              antidiff_box<2>(tile_GC, e, iter, b[2]);
+            }
+
+            const auto &GC = iter == 0 ? this->mem->GC : tile_GC;
+            auto &flx = iga && iter != 0 ? tile_GC : tile_flux; // infinite gauge: GC_corr used as fluxes
+            if (!iga || iter == 0)
+            {
+              flux_box<0>(flx, psi[n], GC[0], b[0]);
+              flux_box<1>(flx, psi[n], GC[1], b[1]);
+              flux_box<2>(flx, psi[n], GC[2], b[2]);
+            }
+
+            if (ti.first() == this->i.first()) this->bcs[0][this->bcs_swapped(0) ? 1 : 0]->fill_halos_flux(flx, j, k);
+            if (ti.last()  == this->i.last())  this->bcs[0][this->bcs_swapped(0) ? 0 : 1]->fill_halos_flux(flx, j, k);
+            for (auto &bc : this->bcs[1]) bc->fill_halos_flux(flx, k, ti);
+            for (auto &bc : this->bcs[2]) bc->fill_halos_flux(flx, ti, j);
+
+	    formulae::donorcell::donorcell<ct_params_t::opts>(
+	      psi[n+1], 
+	      psi[n  ], 
+              flx,
+              *this->mem->G,
+              ti, j, k
+	    ); 
+          }
+        }
+
+        // true if a given iteration is done by advop_single_pass() (which takes precedence over advop_tiled()): 
+        // the last corrective one unless fct, iga or the divergence form of the antidiffusive velocity is used
+        bool single_pass_iter(const int iter) const
+        {
+          return single_pass &&
+            !opts::isset(ct_params_t::opts, opts::fct) &&
+            !opts::isset(ct_params_t::opts, opts::iga) &&
+            !opts::isset(ct_params_t::opts, opts::div_2nd) &&
+            !opts::isset(ct_params_t::opts, opts::div_3rd) &&
+            iter != 0 && iter == this->n_iters - 1;
+        }
+
+        // a corrective iteration done in a single pass, neither storing nor exchanging 
+        // the antidiffusive velocities and fluxes (see mpdata_osc_2d::advop_single_pass())
+        void advop_single_pass(const int e, const int iter)
+        {
+          this->cycle(e);
+          this->xchng(e);
+
+          using cm_t = formulae::cmpt_t<ct_params_t::opts, typename ct_params_t::real_t>;
+          const auto &psi(this->mem->psi[e][this->n[e]]);
+          auto &psi_new(this->mem->psi[e][this->n[e]+1]);
+          const auto &GC(this->GC_unco(iter));
+          const auto &G(*this->mem->G);
+
+          // cells adjacent to the edges with the zero-flux condition (the ones before the first are never reached)
+          const int 
+            il = this->mirror_flux(0, false) ? this->i.first() : this->i.first() - 1,
+            ir = this->mirror_flux(0, true)  ? this->i.last()  : this->i.first() - 1,
+            jl = this->mirror_flux(1, false) ? this->j.first() : this->j.first() - 1,
+            jr = this->mirror_flux(1, true)  ? this->j.last()  : this->j.first() - 1,
+            kl = this->mirror_flux(2, false) ? this->k.first() : this->k.first() - 1,
+            kr = this->mirror_flux(2, true)  ? this->k.last()  : this->k.first() - 1;
+
+          // fluxes through the (i+1/2, j, k), (i, j+1/2, k) and (i, j, k+1/2) faces
+          auto flx_x = [&](const int i, const int j, const int k) -> cm_t
+          {
+            return formulae::donorcell::F_pt<ct_params_t::opts>(cm_t(psi(i, j, k)), cm_t(psi(i+1, j, k)), 
+              cm_t(formulae::mpdata::antidiff_pt<ct_params_t::opts, 0>(psi, GC, G, i, j, k))
+            );
+          };
+          auto flx_y = [&](const int i, const int j, const int k) -> cm_t
+          {
+            return formulae::donorcell::F_pt<ct_params_t::opts>(cm_t(psi(i, j, k)), cm_t(psi(i, j+1, k)), 
+              cm_t(formulae::mpdata::antidiff_pt<ct_params_t::opts, 1>(psi, GC, G, j, k, i))
+            );
+          };
+          auto flx_z = [&](const int i, const int j, const int k) -> cm_t
+          {
+            return formulae::donorcell::F_pt<ct_params_t::opts>(cm_t(psi(i, j, k)), cm_t(psi(i, j, k+1)), 
+              cm_t(formulae::mpdata::antidiff_pt<ct_params_t::opts, 2>(psi, GC, G, k, i, j))
+            );
+          };
+
+          formulae::simd::for_each<0>(this->i, this->j, this->k, [&](const int i, const int j, const int k)
+          {
+            const cm_t
+              fx_l = flx_x(i-1, j, k), fx_r = flx_x(i, j, k),
+              fy_l = flx_y(i, j-1, k), fy_r = flx_y(i, j, k),
+              fz_l = flx_z(i, j, k-1), fz_r = flx_z(i, j, k);
+            psi_new(i, j, k) = formulae::donorcell::donorcell_pt<ct_params_t::opts>(
+              cm_t(psi(i, j, k)),
+              i == ir ? -fx_l : fx_r, i == il ? -fx_r : fx_l,
+              j == jr ? -fy_l : fy_r, j == jl ? -fy_r : fy_l,
+              k == kr ? -fz_l : fz_r, k == kl ? -fz_r : fz_l,
+              formulae::G<ct_params_t::opts, 0>(G, i, j, k)
+            );
+          });
+        }
+
 	// method invoked by the solver
 	void advop(int e)
 	{
+	  this->eqn_tmp(e);
 	  this->fct_init(e);
 
 	  for (int iter = 0; iter < this->n_iters; ++iter) 
 	  {
+            if (single_pass_iter(iter))
+            {
+              advop_single_pass(e, iter);
+              continue;
+            }
+
+            if (tiled_iter(iter))
+            {
+              advop_tiled(e, iter);
+              if (this->upwind_filter_freq > 0 && this->timestep % this->upwind_filter_freq == 0) break;
+              continue;
+            }
+
+            // true if fluxes in the subdomain interior were computed before the halo exchange
+            bool flux_intr = false;
+
 	    if (iter != 0)
 	    {
 	      this->cycle(e);
-              this->xchng(e);
+
+              // the halo exchange is overlapped with computation of the antidiffusive velocities
+              // (and of the fluxes if not altered by fct or replaced by iga) in the subdomain interior,
+              // the remaining shell is computed once the halos are filled
+              const bool xchng_pending = this->xchng_begin(e);
+              const bool ovrlp = xchng_pending && !intr[0].empty();
+              if (ovrlp)
+              {
+                antidiff_boxes(e, iter, intr);
+                if (!opts::isset(ct_params_t::opts, opts::fct) && !opts::isset(ct_params_t::opts, opts::iga))
+                {
+                  flux_boxes(e, iter, intr);
+                  flux_intr = true;
+                }
+              }
+              if (xchng_pending) this->xchng_end(e);
 
 	      // calculating the antidiffusive C 
-              formulae::mpdata::antidiff<ct_params_t::opts, 0,
-                                         static_cast<sptl_intrp_t>(ct_params_t::sptl_intrp),
-                                         static_cast<tmprl_extrp_t>(ct_params_t::tmprl_extrp)>(
-                this->GC_corr(iter)[0],
-                this->mem->psi[e][this->n[e]], 
-                this->mem->psi[e][this->n[e]-1],
-                this->GC_unco(iter),
-                this->mem->ndt_GC,
-                this->mem->ndtt_GC,
-                *this->mem->G,
-                this->im,
-                this->j,
-                this->k
-              );
-
-              formulae::mpdata::antidiff<ct_params_t::opts, 1,
-                                         static_cast<sptl_intrp_t>(ct_params_t::sptl_intrp),
-                                         static_cast<tmprl_extrp_t>(ct_params_t::tmprl_extrp)>(
-                this->GC_corr(iter)[1],
-                this->mem->psi[e][this->n[e]], 
-                this->mem->psi[e][this->n[e]-1], 
-                this->GC_unco(iter),
-                this->mem->ndt_GC,
-                this->mem->ndtt_GC,
-                *this->mem->G,
-                this->jm,
-                this->k,
-                this->i
-              );
-            
-              formulae::mpdata::antidiff<ct_params_t::opts, 2,
-                                         static_cast<sptl_intrp_t>(ct_params_t::sptl_intrp),
-                                         static_cast<tmprl_extrp_t>(ct_params_t::tmprl_extrp)>(
-                this->GC_corr(iter)[2],
-                this->mem->psi[e][this->n[e]], 
-                this->mem->psi[e][this->n[e]-1], 
-                this->GC_unco(iter),
-                this->mem->ndt_GC,
-                this->mem->ndtt_GC,
-                *this->mem->G,
-                this->km,
-                this->i,
-                this->j
-              );
+              antidiff_boxes(e, iter, ovrlp ? shll : full);
 	    
               if (opts::isset(ct_params_t::opts, opts::div_3rd_dt))
                 this->mem->barrier();
@@ -148,7 +423,7 @@ namespace libmpdataxx
 
             const auto &i(this->i), &j(this->j), &k(this->k);
             const auto &ijk(this->ijk);
-            const auto &psi(this->mem->psi[e]);
+            auto &psi(this->mem->psi[e]);
             const auto &n(this->n[e]);
             auto &GC(this->GC(iter));
             using namespace formulae::donorcell;
@@ -156,9 +431,7 @@ namespace libmpdataxx
             // calculation of fluxes
             if (!opts::isset(ct_params_t::opts, opts::iga) || iter == 0)
             {
-              this->flux[0](im+h, j, k) = make_flux<ct_params_t::opts, 0>(psi[n], GC[0], im, j, k);
-              this->flux[1](i, jm+h, k) = make_flux<ct_params_t::opts, 1>(psi[n], GC[1], jm, k, i);
-              this->flux[2](i, j, km+h) = make_flux<ct_params_t::opts, 2>(psi[n], GC[2], km, i, j);
+              flux_boxes(e, iter, flux_intr ? shll : full);
               this->flux_ptr = &this->flux; // TODO: if !iga this is needed only once per simulation, TODO: move to common
             }
             else
@@ -178,18 +451,12 @@ namespace libmpdataxx
 
 	    // donor-cell call 
 	    // TODO: doing antidiff,upstream,antidiff,upstream (for each dimension separately) could help optimise memory consumption!
-	    donorcell_sum<ct_params_t::opts>(
-	      this->mem->khn_tmp,
-              ijk,
-	      psi[n+1](ijk), 
-	      psi[n  ](ijk), 
-              flx[0](i+h, j,   k  ),
-              flx[0](i-h, j,   k  ),
-              flx[1](i,   j+h, k  ),
-              flx[1](i,   j-h, k  ),
-              flx[2](i,   j,   k+h),
-              flx[2](i,   j,   k-h),
-              formulae::G<ct_params_t::opts, 0>(*this->mem->G, i, j, k)
+	    donorcell<ct_params_t::opts>(
+	      psi[n+1], 
+	      psi[n  ], 
+              flx,
+              *this->mem->G,
+              i, j, k
 	    ); 
             
             if (this->upwind_filter_freq > 0 && this->timestep % this->upwind_filter_freq == 0)
@@ -201,6 +468,116 @@ namespace libmpdataxx
 	  }
 	}
 
+        // the full boxes (see set_boxes()) restricted to a tile of x-rows
+        std::array<std::vector<box_t>, 3> tile_boxes(const rng_t &ti) const
+        {
+          std::array<std::vector<box_t>, 3> ret;
+          ret[0].push_back(box_t({rng_t(ti.first() - 1, ti.last()), this->j, this->k}));
+          ret[1].push_back(box_t({ti, jm, this->k}));
+          ret[2].push_back(box_t({ti, this->j, km}));
+          return ret;
+        }
+
+        // advection of several equations sharing the advector done tile by tile (see mpdata_common::tiles()),
+        // so that the advector components of a tile are brought to cache once for all the equations;
+        // gives the same results as advop() called for each equation (which is used if fct is set)
+        void advop_fused(const std::vector<int> &eqns)
+        {
+          if (opts::isset(ct_params_t::opts, opts::fct)) 
+          {
+            parent_t::advop_fused(eqns);
+            return;
+          }
+
+          const auto &j(this->j), &k(this->k);
+          const auto tiles = this->tiles();
+
+          this->xchng_eqns(eqns);
+
+	  for (int iter = 0; iter < this->n_iters; ++iter) 
+	  {
+	    if (iter != 0)
+	    {
+              for (const int &e : eqns) this->cycle(e);
+              this->xchng_eqns(eqns);
+
+	      // calculating the antidiffusive C 
+              for (const auto &ti : tiles)
+              {
+                const auto tb = tile_boxes(ti);
+                for (const int &e : eqns)
+                {
+                  this->eqn_tmp(e);
+                  antidiff_boxes(e, iter, tb);
+                }
+              }
+	    
+              if (opts::isset(ct_params_t::opts, opts::div_3rd_dt))
+                this->mem->barrier();
+              
+              if (iter != (this->n_iters - 1))
+              {
+                for (const int &e : eqns)
+                {
+                  this->eqn_tmp(e);
+                  this->xchng_vctr_nrml(this->GC_corr(iter), this->ijk);
+                  if (opts::isset(ct_params_t::opts, opts::dfl)) this->xchng_vctr_alng(this->GC_corr(iter));
+                }
+              }
+	    }
+
+            // calculation of fluxes
+            std::vector<arrvec_t<typename parent_t::arr_t>*> flxs;
+            if (!opts::isset(ct_params_t::opts, opts::iga) || iter == 0)
+            {
+              for (const auto &ti : tiles)
+              {
+                const auto tb = tile_boxes(ti);
+                for (const int &e : eqns)
+                {
+                  this->eqn_tmp(e);
+                  flux_boxes(e, iter, tb);
+                }
+              }
+              for (const int &e : eqns) flxs.push_back(&this->eqn_flux(e));
+            }
+            else
+            {
+              assert(iter == 1); // infinite gauge option uses just one corrective step
+              for (const int &e : eqns) 
+              {
+                this->eqn_tmp(e);
+                flxs.push_back(&this->GC(iter));
+              }
+            }
+            
+            this->xchng_flux(flxs);
+
+	    // donor-cell call 
+            for (const auto &ti : tiles)
+            {
+              for (int f = 0; f < int(eqns.size()); ++f)
+              {
+                auto &psi(this->mem->psi[eqns[f]]);
+                const auto &n(this->n[eqns[f]]);
+                const auto &flx = *flxs[f];
+	        formulae::donorcell::donorcell<ct_params_t::opts>(
+	          psi[n+1], 
+	          psi[n  ], 
+                  flx,
+                  *this->mem->G,
+                  ti, j, k
+	        ); 
+              }
+            }
+            
+            if (this->upwind_filter_freq > 0 && this->timestep % this->upwind_filter_freq == 0)
+            {
+              break;
+            }
+	  }
+	}
+
         // performs advection of a given field using the donorcell scheme
         // and stores the result in the same field
         // useful for advecting right-hand-sides etc
@@ -255,8 +632,13 @@ namespace libmpdataxx
 	  parent_t(args, p),
 	  im(args.i.first() - 1, args.i.last()),
 	  jm(args.j.first() - 1, args.j.last()),
-	  km(args.k.first() - 1, args.k.last())
-	{ }
+	  km(args.k.first() - 1, args.k.last()),
+          tiled(p.tiled),
+          single_pass(p.single_pass)
+	{
+          set_boxes();
+          set_tiles();
+        }
       };
     } // namespace detail
   } // namespace solvers
@@ -16,10 +16,16 @@ namespace libmpdataxx
   {
     namespace detail
     {
+      const int prs_min_halo = 2; // lap() reads two points away (centred differences of centred differences)
+
       template <class ct_params_t, int minhalo>
-      class mpdata_rhs_vip_prs_common : public mpdata_rhs_vip<ct_params_t, minhalo>
+      class mpdata_rhs_vip_prs_common : public mpdata_rhs_vip<
+        ct_params_t, detail::max(minhalo, prs_min_halo)
+      >
       {
-	using parent_t = mpdata_rhs_vip<ct_params_t, minhalo>;
+	using parent_t = mpdata_rhs_vip<
+          ct_params_t, detail::max(minhalo, prs_min_halo)
+        >;
         using ix = typename ct_params_t::ix;
 	using ijk_t = decltype(mpdata_rhs_vip_prs_common<ct_params_t, minhalo>::ijk);
 
@@ -35,7 +41,12 @@ namespace libmpdataxx
         bool converged = false;
 
         arr_t Phi, err;
-        arrvec_t<arr_t> &tmp_uvw, &lap_tmp;
+        arrvec_t<arr_t> &tmp_uvw, &lap_tmp, &lap_coeff;
+
+        // lap_coeff recomputed only if invalidated or if simple or dt changed
+        // (lap_coeff_fresh telling the pressure_solver_loop_init() if it was in the current solve)
+        bool lap_coeff_valid = false, lap_coeff_simple = false, lap_coeff_fresh = false;
+        real_t lap_coeff_dt = 0;
 
         real_t prs_sum(const arr_t &arr, const ijk_t &ijk)
         {
@@ -47,7 +58,36 @@ namespace libmpdataxx
           return this->mem->sum(arr1, arr2, ijk, ct_params_t::prs_khn);
         }
 
-        auto lap(
+        // several sums of (element-wise) products and (optionally) the maximum of |absmax_arr|
+        // at the synchronisation cost of a single prs_sum() call
+        std::vector<double> prs_reduce(
+          const std::vector<std::pair<const arr_t*, const arr_t*>> &prods, 
+          const ijk_t &ijk,
+          const arr_t *absmax_arr = nullptr
+        )
+        {
+          return this->mem->reduce(this->rank, prods, ijk, ct_params_t::prs_khn, absmax_arr);
+        }
+
+        // the same split into two parts, to overlap the synchronisation with other work
+        // (see sharedmem::reduce_post() and sharedmem::reduce_wait())
+        void prs_reduce_post(
+          const std::vector<std::pair<const arr_t*, const arr_t*>> &prods, 
+          const ijk_t &ijk,
+          const arr_t *absmax_arr = nullptr
+        )
+        {
+          this->mem->reduce_post(this->rank, prods, ijk, ct_params_t::prs_khn, absmax_arr);
+        }
+
+        std::vector<double> prs_reduce_wait(const int n_sums, const bool absmax = false)
+        {
+          return this->mem->reduce_wait(this->rank, n_sums, ct_params_t::prs_khn, absmax);
+        }
+
+        // the Laplacian as the divergence of the gradient multiplied by G, normalised and with
+        // the edge values set as for the velocities (see lap() below for the iterations)
+        auto div_grad(
           arr_t &arr, 
           const ijk_t &ijk, 
           const std::array<real_t, parent_t::n_dims>& dijk, 
@@ -81,6 +121,91 @@ namespace libmpdataxx
           / formulae::G<ct_params_t::opts>(*this->mem->G, this->ijk)
         )
 
+        // the coefficients of div_grad() without err_init: G times the normalize_vip() factors,
+        // with the edge values and halos set as those of the gradient in div_grad(), hence with
+        // the edge conditions folded in; G and the normalize_vip() factors other than dt are
+        // assumed not to change within solve() (see cache_invalidate()), hence these are
+        // recomputed only on the first pressure solve of a solve() call or if dt or simple changed
+        void lap_coeff_init(bool simple)
+        {
+          lap_coeff_fresh = !lap_coeff_valid || simple != lap_coeff_simple || this->dt != lap_coeff_dt;
+          if (!lap_coeff_fresh) return;
+
+          for (int d = 0; d < parent_t::n_dims; ++d)
+          {
+            if (this->mem->G) lap_coeff[d](this->ijk) = (*this->mem->G)(this->ijk);
+            else lap_coeff[d](this->ijk) = real_t(1);
+          }
+          if (!simple) this->normalize_vip(lap_coeff);
+          this->set_edges(lap_coeff, this->ijk, 0);
+          for (int d = 0; d < parent_t::n_dims; ++d)
+          {
+            this->xchng_pres(lap_coeff[d], this->ijk);
+          }
+
+          lap_coeff_valid = true;
+          lap_coeff_simple = simple;
+          lap_coeff_dt = this->dt;
+        }
+
+        // G (as well as e.g. vab_coeff) might have been modified from outside since the last solve()
+        void cache_invalidate()
+        {
+          parent_t::cache_invalidate();
+          lap_coeff_valid = false;
+        }
+
+        // the edges and halos of lap_coeff set by the previous owners of the subdomain
+        void set_subdomain(const idx_t<parent_t::n_dims> &ijk_new)
+        {
+          parent_t::set_subdomain(ijk_new);
+          lap_coeff_valid = false;
+        }
+
+        // at the edges with the zero-flux condition, the halos of arr extrapolated as an odd function
+        // about the edge (as by fill_halos_pres() of the rigid edges, the open ones fill only a part of the halo) 
+        void xtrp_pres(arr_t &arr, const ijk_t &ijk)
+        {
+          for (int d = 0; d < parent_t::n_dims; ++d)
+          {
+            for (const bool rght : {false, true})
+            {
+              if (!this->mirror_pres(d, rght)) continue;
+
+              auto edge = ijk, hlo = ijk, intr = ijk;
+              const int e = rght ? ijk.ubound(d) : ijk.lbound(d), o = rght ? 1 : -1;
+              edge.lbound(d) = edge.ubound(d) = e;
+              for (int n = 1; n <= 2; ++n)
+              {
+                hlo.lbound(d)  = hlo.ubound(d)  = e + o * n;
+                intr.lbound(d) = intr.ubound(d) = e - o * n;
+                arr(hlo) = 2 * arr(edge) - arr(intr);
+              }
+            }
+          }
+        }
+
+        // the operator of the pressure solvers: equal to div_grad() without err_init 
+        // (with simple as in the last lap_coeff_init() call) but computed in a single pass
+        // with a 5-point (2D) or 7-point (3D) stencil and a single halo exchange;
+        // arr is read around each point (also in the neighbouring subdomains) so the result
+        // must not be assigned into arr itself - evaluate into a temporary and update arr
+        // after a nghbr_barrier() or a reduction
+        auto lap(
+          arr_t &arr, 
+          const ijk_t &ijk, 
+          const std::array<real_t, parent_t::n_dims>& dijk, 
+          bool err_init,
+          bool // simple
+        ) return_macro(
+          assert(!err_init && "lap() called with err_init, use div_grad()"); (void)err_init;
+          this->xchng_pres(arr, ijk);
+          xtrp_pres(arr, ijk);
+          ,
+          formulae::nabla::lap<parent_t::n_dims>(arr, lap_coeff, ijk, dijk)
+          / formulae::G<ct_params_t::opts>(*this->mem->G, this->ijk)
+        )
+
 	void ini_pressure()
 	{ 
 	  Phi(this->ijk) = 0;
@@ -106,7 +231,9 @@ namespace libmpdataxx
           }
 
 	  //initial error   
-          err(this->ijk) = lap(Phi, this->ijk, this->dijk, true, simple);
+          err(this->ijk) = div_grad(Phi, this->ijk, this->dijk, true, simple);
+
+          lap_coeff_init(simple);
 
 	  iters = 0;
           converged = false;
@@ -206,7 +333,8 @@ namespace libmpdataxx
                Phi(args.mem->tmp[__FILE__][0][0]),
                err(args.mem->tmp[__FILE__][0][1]),
            tmp_uvw(args.mem->tmp[__FILE__][1]),
-	   lap_tmp(args.mem->tmp[__FILE__][2])
+	   lap_tmp(args.mem->tmp[__FILE__][2]),
+	 lap_coeff(args.mem->tmp[__FILE__][3])
 	{} 
 
 	static void alloc(
@@ -217,6 +345,7 @@ namespace libmpdataxx
           parent_t::alloc_tmp_sclr(mem, __FILE__, 2); // Phi, err
           parent_t::alloc_tmp_sclr(mem, __FILE__, parent_t::n_dims); // tmp_uvw
           parent_t::alloc_tmp_sclr(mem, __FILE__, parent_t::n_dims); // lap_tmp
+          parent_t::alloc_tmp_sclr(mem, __FILE__, parent_t::n_dims); // lap_coeff
         }
       }; 
     } // namespace detail
@@ -0,0 +1,350 @@
+/**
+  * @file
+  * @copyright University of Warsaw
+  * @section LICENSE
+  * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+  *
+  * @brief direct (FFT-based) pressure solver for constant G and homogeneous boundary conditions:
+  *   the inverse of the constant-coefficient operator used as a preconditioner of the generalized
+  *   conjugate residual scheme (cf. mpdata_rhs_vip_prs_gcrk.hpp), and hence converging in a single
+  *   iteration for the "simple" operator; requires the FFTW library (http://www.fftw.org/, with real_t = float
+  *   its single-precision variant) and is not available with MPI (see mpdata_rhs_vip_prs.hpp)
+  */
+
+#pragma once
+
+#include <libmpdata++/solvers/detail/mpdata_rhs_vip_prs_common.hpp>
+
+#include <fftw3.h>
+
+#include <cmath>
+#include <mutex>
+
+namespace libmpdataxx
+{
+  namespace solvers
+  {
+    namespace detail
+    {
+      // single- and double-precision FFTW interfaces
+      template <typename real_t> struct fftw_t
+      {
+        static_assert(sizeof(real_t) == 0,
+          "the fft pressure solver supports double and, if single-precision FFTW was found (-DUSE_FFTWF), float");
+      };
+
+      template <>
+      struct fftw_t<double>
+      {
+        using plan_t = fftw_plan;
+        static plan_t plan(int n, double *a, int stride, fftw_r2r_kind kind)
+        {
+          return fftw_plan_many_r2r(1, &n, 1, a, nullptr, stride, 0, a, nullptr, stride, 0, &kind, FFTW_ESTIMATE | FFTW_UNALIGNED);
+        }
+        static void execute(const plan_t &p, double *a) { fftw_execute_r2r(p, a, a); }
+        static void destroy(const plan_t &p) { fftw_destroy_plan(p); }
+      };
+
+#if defined(USE_FFTWF)
+      template <>
+      struct fftw_t<float>
+      {
+        using plan_t = fftwf_plan;
+        static plan_t plan(int n, float *a, int stride, fftw_r2r_kind kind)
+        {
+          return fftwf_plan_many_r2r(1, &n, 1, a, nullptr, stride, 0, a, nullptr, stride, 0, &kind, FFTW_ESTIMATE | FFTW_UNALIGNED);
+        }
+        static void execute(const plan_t &p, float *a) { fftwf_execute_r2r(p, a, a); }
+        static void destroy(const plan_t &p) { fftwf_destroy_plan(p); }
+      };
+#endif
+
+      template <class ct_params_t, int k_iters, int minhalo>
+      class mpdata_rhs_vip_prs_fft : public detail::mpdata_rhs_vip_prs_common<ct_params_t, minhalo>
+      {
+        public:
+
+	using real_t = typename ct_params_t::real_t;
+
+        private:
+
+	using parent_t = detail::mpdata_rhs_vip_prs_common<ct_params_t, minhalo>;
+        using ix = typename ct_params_t::ix;
+        using int_idx_t = idxperm::int_idx_t<parent_t::n_dims>;
+        using fftw = fftw_t<real_t>;
+
+        // The centred differences in lap() give, along each dimension, the operator
+        // (x[i+2] - 2 x[i] + x[i-2]) / (4 dx^2). For cyclic edges (period n-1) it is diagonalised by
+        // the real discrete Fourier transform, for the other edges (zero normal gradient at the edge points,
+        // equivalent to mirroring about them) by the type-I discrete cosine transform, the eigenvalues
+        // being -sin^2(pi k / (n-1) * (cyclic ? 2 : 1)) / dx^2. The transforms are done along one dimension
+        // at a time, the grid lines being divided among the threads. The modes with zero eigenvalues
+        // (constants on the 2^n_dims sub-lattices of same-parity points) are not corrected.
+
+	real_t beta;
+        std::vector<real_t> alpha, tmp_den;
+	typename parent_t::arr_t q_err, lap_q_err, bcfl;
+	arrvec_t<typename parent_t::arr_t> p_err, lap_p_err;
+
+        std::array<bool, parent_t::n_dims> cyc;
+        std::array<std::vector<real_t>, parent_t::n_dims> eigv;
+        std::array<typename fftw::plan_t, parent_t::n_dims> fwd, bwd;
+        bool planned = false;
+
+        // FFTW planner is not thread-safe
+        static std::mutex &plan_mutex()
+        {
+          static std::mutex m;
+          return m;
+        }
+
+        // number of points transformed along dimension d
+        int n_trans(const int d) const
+        {
+          return this->mem->grid_size[d].length() - (cyc[d] ? 1 : 0);
+        }
+
+        void plan()
+        {
+          std::lock_guard<std::mutex> lock(plan_mutex());
+          for (int d = 0; d < parent_t::n_dims; ++d)
+          {
+            int_idx_t fl(0);
+            fl[0] = d;
+            cyc[d] = bcfl(fl) != 0;
+
+            const int n = n_trans(d);
+            if (n < (cyc[d] ? 1 : 2))
+              throw std::runtime_error("grid too small for the fft pressure solver");
+
+            real_t *a = q_err.dataFirst();
+            fwd[d] = fftw::plan(n, a, q_err.stride(d), cyc[d] ? FFTW_R2HC : FFTW_REDFT00);
+            bwd[d] = fftw::plan(n, a, q_err.stride(d), cyc[d] ? FFTW_HC2R : FFTW_REDFT00);
+
+            eigv[d].resize(n);
+            const real_t pi = std::acos(real_t(-1));
+            for (int k = 0; k < n; ++k)
+              eigv[d][k] = -pow2(std::sin(cyc[d] ? 2 * pi * k / n : pi * k / (n - 1))) / pow2(this->dijk[d]);
+          }
+          planned = true;
+        }
+
+        // true if the eigenvalue along dimension d of the mode k is zero
+        bool zero_eigv(const int d, const int k) const
+        {
+          const int n = n_trans(d);
+          return cyc[d] ? (k == 0 || 2 * k == n) : (k == 0 || k == n - 1);
+        }
+
+        // applies the transforms along dimension d to the grid lines assigned to the thread
+        void trans(const int d, const std::array<typename fftw::plan_t, parent_t::n_dims> &plans)
+        {
+          int n_lines = 1;
+          for (int e = 0; e < parent_t::n_dims; ++e) if (e != d) n_lines *= n_trans(e);
+
+          for (
+            int l = n_lines * this->rank / this->mem->size;
+            l < n_lines * (this->rank + 1) / this->mem->size;
+            ++l
+          )
+          {
+            int_idx_t i;
+            int rest = l;
+            for (int e = parent_t::n_dims - 1; e >= 0; --e)
+            {
+              if (e == d)
+              {
+                i[e] = this->mem->grid_size[e].first();
+                continue;
+              }
+              i[e] = this->mem->grid_size[e].first() + rest % n_trans(e);
+              rest /= n_trans(e);
+            }
+            fftw::execute(plans[d], &q_err(i));
+          }
+          this->mem->barrier();
+        }
+
+        // calls body(i) for each point i owned by the thread
+        template <class body_t>
+        void for_ijk(const body_t &body) const
+        {
+          int_idx_t i = this->ijk.lbound();
+          while (true)
+          {
+            body(i);
+            int d = parent_t::n_dims - 1;
+            for (; d >= 0 && i[d] == this->ijk.ubound(d); --d) i[d] = this->ijk.lbound(d);
+            if (d < 0) return;
+            ++i[d];
+          }
+        }
+
+        // q_err = the inverse of the constant-coefficient operator applied to err
+        void fft_solve()
+        {
+          q_err(this->ijk) = this->err(this->ijk);
+          this->mem->barrier();
+
+          for (int d = 0; d < parent_t::n_dims; ++d) trans(d, fwd);
+
+          real_t norm = 1;
+          for (int d = 0; d < parent_t::n_dims; ++d) norm *= cyc[d] ? n_trans(d) : 2 * (n_trans(d) - 1);
+
+          for_ijk([&](const int_idx_t &i)
+          {
+            real_t eig = 0;
+            bool zero = true;
+            for (int d = 0; d < parent_t::n_dims; ++d)
+            {
+              const int k = i[d] - this->mem->grid_size[d].first();
+              if (k == n_trans(d)) return; // the last point of a cyclic dimension, not transformed
+              eig += eigv[d][k];
+              zero = zero && zero_eigv(d, k);
+            }
+            q_err(i) = zero ? 0 : q_err(i) / (norm * eig);
+          });
+          this->mem->barrier();
+
+          for (int d = 0; d < parent_t::n_dims; ++d) trans(d, bwd);
+
+          // the last points along cyclic dimensions are copies of the first ones
+          for_ijk([&](const int_idx_t &i)
+          {
+            int_idx_t src = i;
+            bool copy = false;
+            for (int d = 0; d < parent_t::n_dims; ++d)
+            {
+              if (cyc[d] && i[d] == this->mem->grid_size[d].last())
+              {
+                src[d] = this->mem->grid_size[d].first();
+                copy = true;
+              }
+            }
+            if (copy) q_err(i) = q_err(src);
+          });
+        }
+
+        void pressure_solver_loop_init(bool simple) final
+        {
+          if (!planned) plan();
+
+          fft_solve();
+	  p_err[0](this->ijk) = q_err(this->ijk);
+	  lap_p_err[0](this->ijk) = this->lap(p_err[0], this->ijk, this->dijk, false, simple);
+        }
+
+        void pressure_solver_loop_body(bool simple) final
+        {
+          for (int v = 0; v < k_iters; ++v)
+          {
+            // both scalar products within a single reduction
+            {
+              const auto sums = this->prs_reduce({{&lap_p_err[v], &lap_p_err[v]}, {&this->err, &lap_p_err[v]}}, this->ijk);
+              tmp_den[v] = sums[0];
+              if (tmp_den[v] != 0) beta = - sums[1] / tmp_den[v];
+            }
+            this->Phi(this->ijk) += beta * p_err[v](this->ijk);
+            this->err(this->ijk) += beta * lap_p_err[v](this->ijk);
+
+            fft_solve();
+            lap_q_err(this->ijk) = this->lap(q_err, this->ijk, this->dijk, false, simple);
+
+            // all the alpha coefficients and the error norm within a single reduction
+            {
+              std::vector<std::pair<const typename parent_t::arr_t*, const typename parent_t::arr_t*>> prods;
+              for (int l = 0; l <= v; ++l) prods.emplace_back(&lap_q_err, &lap_p_err[l]);
+              const auto sums = this->prs_reduce(prods, this->ijk, &this->err);
+
+              for (int l = 0; l <= v; ++l)
+              {
+                if (tmp_den[l] != 0)
+                  alpha[l] = - sums[l] / tmp_den[l];
+              }
+
+              const real_t error = sums[v + 1];
+              if (error <= this->err_tol) this->converged = true;
+            }
+
+            // no further (costly) preconditioning once converged
+            if (this->converged) return;
+
+            const int w = v < (k_iters - 1) ? v + 1 : 0;
+            p_err[w](this->ijk) = q_err(this->ijk) + alpha[0] * p_err[0](this->ijk);
+            lap_p_err[w](this->ijk) = lap_q_err(this->ijk) + alpha[0] * lap_p_err[0](this->ijk);
+            for (int l = 1; l <= v; ++l)
+            {
+              p_err[w](this->ijk) += alpha[l] * p_err[l](this->ijk);
+              lap_p_err[w](this->ijk) += alpha[l] * lap_p_err[l](this->ijk);
+            }
+          }
+        }
+
+	public:
+
+	// ctor
+	mpdata_rhs_vip_prs_fft(
+	  typename parent_t::ctor_args_t args,
+	  const typename parent_t::rt_params_t &p
+	) :
+	  parent_t(args, p),
+          beta(.25),
+          alpha(k_iters, 1.),
+          tmp_den(k_iters, 1.),
+	      q_err(args.mem->tmp[__FILE__][0][0]),
+	  lap_q_err(args.mem->tmp[__FILE__][0][1]),
+	       bcfl(args.mem->tmp[__FILE__][3][0]),
+	      p_err(args.mem->tmp[__FILE__][1]),
+	  lap_p_err(args.mem->tmp[__FILE__][2])
+	{}
+
+        // dtor
+        ~mpdata_rhs_vip_prs_fft()
+        {
+          if (!planned) return;
+          std::lock_guard<std::mutex> lock(plan_mutex());
+          for (int d = 0; d < parent_t::n_dims; ++d)
+          {
+            fftw::destroy(fwd[d]);
+            fftw::destroy(bwd[d]);
+          }
+        }
+
+	static void alloc(
+          typename parent_t::mem_t *mem,
+          const int &n_iters
+        ) {
+	  parent_t::alloc(mem, n_iters);
+	  parent_t::alloc_tmp_sclr(mem, __FILE__, 2); // q_err, lap_q_err
+	  parent_t::alloc_tmp_sclr(mem, __FILE__, k_iters); // p_err
+	  parent_t::alloc_tmp_sclr(mem, __FILE__, k_iters); // lap_p_err
+
+          // flags marking the cyclic dimensions (set in alloc_bcond())
+          int_idx_t fl_shape(1);
+          fl_shape[0] = parent_t::n_dims;
+          mem->tmp[__FILE__].push_back(new arrvec_t<typename parent_t::arr_t>());
+          mem->tmp[__FILE__].back().push_back(mem->old(new typename parent_t::arr_t(fl_shape)));
+          mem->tmp[__FILE__].back()[0] = 0;
+
+          mem->alloc_reduce(std::max(2, k_iters));
+	}
+
+	static void alloc_bcond(
+          typename parent_t::mem_t *mem,
+          const typename parent_t::rt_params_t &p,
+          const std::array<std::array<bool, 2>, parent_t::n_dims> &cyclic
+        ) {
+          parent_t::alloc_bcond(mem, p, cyclic);
+
+          auto &bcfl = mem->tmp[__FILE__][3][0];
+          for (int d = 0; d < parent_t::n_dims; ++d)
+          {
+            int_idx_t fl(0);
+            fl[0] = d;
+            bcfl(fl) = cyclic[d][0];
+          }
+        }
+      };
+    } // namespace detail
+  } // namespace solvers
+} // namespace libmpdataxx
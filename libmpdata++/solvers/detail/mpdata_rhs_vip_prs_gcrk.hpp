@@ -46,24 +46,32 @@ namespace libmpdataxx
         {
           for (int v = 0; v < k_iters; ++v)
           {
-            tmp_den[v] = this->prs_sum(lap_p_err[v], lap_p_err[v], this->ijk);
-            if (tmp_den[v] != 0) beta = - this->prs_sum(this->err, lap_p_err[v], this->ijk) / tmp_den[v];
+            // both scalar products within a single reduction
+            {
+              const auto sums = this->prs_reduce({{&lap_p_err[v], &lap_p_err[v]}, {&this->err, &lap_p_err[v]}}, this->ijk);
+              tmp_den[v] = sums[0];
+              if (tmp_den[v] != 0) beta = - sums[1] / tmp_den[v];
+            }
             this->Phi(this->ijk) += beta * p_err[v](this->ijk);
             this->err(this->ijk) += beta * lap_p_err[v](this->ijk);
 
-            real_t error = std::max(
-              std::abs(this->mem->max(this->rank, this->err(this->ijk))), 
-              std::abs(this->mem->min(this->rank, this->err(this->ijk)))
-            );
-
-            if (error <= this->err_tol) this->converged = true;
-
             lap_err(this->ijk) = this->lap(this->err, this->ijk, this->dijk, false, simple);
 
-            for (int l = 0; l <= v; ++l)
+            // all the alpha coefficients and the error norm within a single reduction
+            // (err is not modified by the Laplacian)
             {
-              if (tmp_den[l] != 0) 
-                alpha[l] = - this->prs_sum(lap_err, lap_p_err[l], this->ijk) / tmp_den[l];
+              std::vector<std::pair<const typename parent_t::arr_t*, const typename parent_t::arr_t*>> prods;
+              for (int l = 0; l <= v; ++l) prods.emplace_back(&lap_err, &lap_p_err[l]);
+              const auto sums = this->prs_reduce(prods, this->ijk, &this->err);
+
+              for (int l = 0; l <= v; ++l)
+              {
+                if (tmp_den[l] != 0) 
+                  alpha[l] = - sums[l] / tmp_den[l];
+              }
+
+              const real_t error = sums[v + 1];
+              if (error <= this->err_tol) this->converged = true;
             }
             
             if (v < (k_iters - 1))
@@ -117,6 +125,7 @@ namespace libmpdataxx
 	  parent_t::alloc_tmp_sclr(mem, __FILE__, 1);
 	  parent_t::alloc_tmp_sclr(mem, __FILE__, k_iters);
 	  parent_t::alloc_tmp_sclr(mem, __FILE__, k_iters);
+          mem->alloc_reduce(std::max(2, k_iters));
 	}
       }; 
     } // namespace detail
@@ -0,0 +1,547 @@
+/**
+  * @file
+  * @copyright University of Warsaw
+  * @section LICENSE
+  * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+  *
+  * @brief geometric multigrid pressure solver: matrix-free V-cycles used as a preconditioner
+  *   of the generalized conjugate residual scheme (cf. mpdata_rhs_vip_prs_gcrk.hpp) or on their own
+  *   (for a general discussion of multigrid methods consult e.g. Trottenberg, Oosterlee & Schuller 2001
+  *    Multigrid, Academic Press)
+  */
+
+#pragma once
+
+#include <libmpdata++/solvers/detail/mpdata_rhs_vip_prs_common.hpp>
+
+namespace libmpdataxx
+{
+  namespace solvers
+  {
+    namespace detail
+    {
+      template <class ct_params_t, int k_iters, int minhalo>
+      class mpdata_rhs_vip_prs_mg : public detail::mpdata_rhs_vip_prs_common<ct_params_t, minhalo>
+      {
+        public:
+
+	using real_t = typename ct_params_t::real_t;
+
+        private:
+
+	using parent_t = detail::mpdata_rhs_vip_prs_common<ct_params_t, minhalo>;
+        using ix = typename ct_params_t::ix;
+        using arr_t = typename parent_t::arr_t;
+        using int_idx_t = idxperm::int_idx_t<parent_t::n_dims>;
+
+        // The centred differences in lap() couple every other grid point, i.e. the pressure problem
+        // splits into 2^n_dims independent problems on the sub-lattices of points with the same parities
+        // of indices. Hence, along each coarsened dimension, a coarse-grid point I aggregates the two
+        // same-parity points 2I-s and 2I-s+2 (s = I % 2) of the finer grid - the parities being preserved
+        // on all grids. The coarse-grid operators have the form of lap(): div(a grad(x)) / G with the
+        // centred differences over two points, a being G times the normalize_vip() factors, with a and G
+        // averaged over the aggregates. On the finest grid lap() itself is used. Beyond the domain
+        // edges the coarse-grid indices are wrapped (cyclic edges, see crs_sizes()) or mirrored (zero normal gradient
+        // as in lap() for rigid, open and gndsky edges with homogeneous conditions, as well as at the edges
+        // of the parts of the domain of MPI processes - the coarse grids being local to each process).
+        struct level_t
+        {
+          int_idx_t n;                                    // number of grid points
+          std::array<bool, parent_t::n_dims> c;           // dimensions coarsened w.r.t. the finer grid
+          std::array<real_t, parent_t::n_dims> dijk;      // grid spacing
+          arr_t x, b, r, g;                               // solution, rhs, residual and averaged G
+          std::vector<arr_t> a;                           // coefficients of the gradient components
+          int_idx_t lo, hi;                               // the part of the grid owned by the thread
+        };
+
+	const int mg_sweeps;
+        const bool mg_krylov;
+	real_t beta;
+        std::vector<real_t> alpha, tmp_den;
+	typename parent_t::arr_t q_err, lap_q_err, res, dgnl, bcfl;
+	arrvec_t<typename parent_t::arr_t> p_err, lap_p_err;
+        std::vector<level_t> lev;
+        bool lev_bound = false;
+        std::array<std::array<bool, 2>, parent_t::n_dims> cyc; // cyclic domain edges (left, right)
+
+        // coarse-grid point aggregating point i, and the first point of the aggregate I
+        static int crs(const int i) { return 2 * (i / 4) + i % 2; }
+        static int fst(const int I) { return 4 * (I / 2) + I % 2; }
+
+        // sizes of the coarse grids, a dimension being coarsened as long as it has at least 9 points
+        // (and, if restricted, as long as the number of grid intervals is divisible by 4, i.e. for
+        // cyclic edges as long as the period allows to preserve the parities, and for the other edges
+        // as long as the aggregates do not cross the edges - needed if V-cycles are used on their own)
+        static std::vector<int_idx_t> crs_sizes(
+          const std::array<rng_t, parent_t::n_dims> &grid_size,
+          const std::array<bool, parent_t::n_dims> &restr
+        )
+        {
+          std::vector<int_idx_t> ret;
+          int_idx_t n;
+          for (int d = 0; d < parent_t::n_dims; ++d) n[d] = grid_size[d].length();
+          while (true)
+          {
+            bool crsnd = false;
+            for (int d = 0; d < parent_t::n_dims; ++d)
+            {
+              if (n[d] < 9 || (restr[d] && (n[d] - 1) % 4 != 0)) continue;
+              n[d] = std::max(crs(n[d] - 1), crs(n[d] - 2)) + 1;
+              crsnd = true;
+            }
+            if (!crsnd) return ret;
+            ret.push_back(n);
+          }
+        }
+
+        // calls body(I) for each point I in the box [lo, hi]
+        template <class body_t>
+        static void for_box(const int_idx_t &lo, const int_idx_t &hi, const body_t &body)
+        {
+          for (int d = 0; d < parent_t::n_dims; ++d) if (hi[d] < lo[d]) return;
+          int_idx_t I = lo;
+          while (true)
+          {
+            body(I);
+            int d = parent_t::n_dims - 1;
+            for (; d >= 0 && I[d] == hi[d]; --d) I[d] = lo[d];
+            if (d < 0) return;
+            ++I[d];
+          }
+        }
+
+        // index i (at most two points beyond a domain edge) mapped into [0, n-1]
+        int fold(const int i, const int n, const int d) const
+        {
+          if (i < 0)  return cyc[d][0] ? i + n - 1 : -i;
+          if (i >= n) return cyc[d][1] ? i - n + 1 : 2 * (n - 1) - i;
+          return i;
+        }
+
+        int_idx_t nghbr(int_idx_t I, const int d, const int o, const int_idx_t &n) const
+        {
+          I[d] = fold(I[d] + o, n[d], d);
+          return I;
+        }
+
+        // the coarse-grid counterpart of lap() at point I, and its diagonal coefficient
+        real_t crs_lap(const level_t &lv, const int_idx_t &I, real_t &diag) const
+        {
+          real_t ret = 0;
+          diag = 0;
+          for (int d = 0; d < parent_t::n_dims; ++d)
+          {
+            const real_t
+              al = lv.a[d](nghbr(I, d, -1, lv.n)),
+              ar = lv.a[d](nghbr(I, d,  1, lv.n)),
+              c = 1 / (4 * lv.dijk[d] * lv.dijk[d]);
+            ret += c * (
+              ar * (lv.x(nghbr(I, d, 2, lv.n)) - lv.x(I)) -
+              al * (lv.x(I) - lv.x(nghbr(I, d, -2, lv.n)))
+            );
+            diag -= c * (al + ar);
+          }
+          diag /= lv.g(I);
+          return ret / lv.g(I);
+        }
+
+        // averages over the aggregates of the points of the coarse grid lc owned by the thread
+        // (fine(i) returning the value at point i of the finer grid with nf points)
+        template <class fine_t>
+        void rstr(const level_t &lc, const int_idx_t &nf, const fine_t &fine, arr_t &crs_arr) const
+        {
+          int_idx_t m_hi;
+          int cnt = 1;
+          for (int d = 0; d < parent_t::n_dims; ++d)
+          {
+            m_hi[d] = lc.c[d] ? 1 : 0;
+            cnt *= m_hi[d] + 1;
+          }
+
+          for_box(lc.lo, lc.hi, [&](const int_idx_t &I)
+          {
+            real_t sum = 0;
+            for_box(int_idx_t(0), m_hi, [&](const int_idx_t &m)
+            {
+              int_idx_t i;
+              for (int d = 0; d < parent_t::n_dims; ++d)
+                i[d] = lc.c[d] ? fold(fst(I[d]) + 2 * m[d], nf[d], d) : I[d];
+              sum += fine(i);
+            });
+            crs_arr(I) = sum / cnt;
+          });
+        }
+
+        // adds the coarse-grid solution to the points lo...hi of the finer grid (fine(i) returning a reference)
+        template <class fine_t>
+        void prlng(const level_t &lc, const int_idx_t &lo, const int_idx_t &hi, const fine_t &fine) const
+        {
+          for_box(lo, hi, [&](const int_idx_t &i)
+          {
+            int_idx_t I;
+            for (int d = 0; d < parent_t::n_dims; ++d) I[d] = lc.c[d] ? crs(i[d]) : i[d];
+            fine(i) += lc.x(I);
+          });
+        }
+
+        // damped Jacobi iterations for the coarse-grid problem (starting from zero if zero_init)
+        void crs_smooth(level_t &lv, const int n_sweeps, const bool zero_init)
+        {
+          const real_t omega = real_t(2 * parent_t::n_dims) / (2 * parent_t::n_dims + 1);
+
+          if (zero_init)
+          {
+            for_box(lv.lo, lv.hi, [&](const int_idx_t &I) { lv.x(I) = 0; });
+            this->mem->barrier();
+          }
+
+          for (int s = 0; s < n_sweeps; ++s)
+          {
+            for_box(lv.lo, lv.hi, [&](const int_idx_t &I)
+            {
+              real_t diag;
+              const real_t lap_x = crs_lap(lv, I, diag);
+              lv.r(I) = (lv.b(I) - lap_x) / diag;
+            });
+            this->mem->barrier();
+            for_box(lv.lo, lv.hi, [&](const int_idx_t &I) { lv.x(I) += omega * lv.r(I); });
+            this->mem->barrier();
+          }
+        }
+
+        void crs_vcycle(const int l)
+        {
+          auto &lv = lev[l];
+
+          if (l == int(lev.size()) - 1)
+          {
+            crs_smooth(lv, 8 * mg_sweeps, true);
+            return;
+          }
+
+          crs_smooth(lv, mg_sweeps, true);
+
+          for_box(lv.lo, lv.hi, [&](const int_idx_t &I)
+          {
+            real_t diag;
+            lv.r(I) = lv.b(I) - crs_lap(lv, I, diag);
+          });
+          this->mem->barrier();
+
+          rstr(lev[l + 1], lv.n, [&](const int_idx_t &i) { return lv.r(i); }, lev[l + 1].b);
+          crs_vcycle(l + 1);
+          prlng(lev[l + 1], lv.lo, lv.hi, [&](const int_idx_t &i) -> real_t& { return lv.x(i); });
+          this->mem->barrier();
+
+          crs_smooth(lv, mg_sweeps, false);
+        }
+
+        // damped Jacobi sweep on the finest grid, the residual evaluated into res first as lap() reads 
+        // q_err around each point (also from the neighbouring subdomains)
+        void jacobi_sweep(const real_t omega, bool simple)
+        {
+          res(this->ijk) = this->err(this->ijk) - this->lap(q_err, this->ijk, this->dijk, false, simple);
+          this->mem->nghbr_barrier(this->rank);
+          q_err(this->ijk) += omega * res(this->ijk) / dgnl(this->ijk);
+        }
+
+        // a V-cycle approximating q_err = lap^-1(err), damped Jacobi smoothing on the finest grid
+        void vcycle(bool simple)
+        {
+          const real_t omega = real_t(2 * parent_t::n_dims) / (2 * parent_t::n_dims + 1);
+          const int n_sweeps = lev.empty() ? 2 * mg_sweeps : mg_sweeps;
+
+          q_err(this->ijk) = omega * this->err(this->ijk) / dgnl(this->ijk);
+          for (int s = 1; s < n_sweeps; ++s) jacobi_sweep(omega, simple);
+
+          if (lev.empty()) return;
+
+          res(this->ijk) = this->err(this->ijk) - this->lap(q_err, this->ijk, this->dijk, false, simple);
+          this->mem->barrier();
+
+          rstr(lev[0], n_fine(), [&](const int_idx_t &i) { return res(glb(i)); }, lev[0].b);
+          crs_vcycle(0);
+          prlng(lev[0], own(false), own(true), [&](const int_idx_t &i) -> real_t& { return q_err(glb(i)); });
+
+          for (int s = 0; s < mg_sweeps; ++s) jacobi_sweep(omega, simple);
+        }
+
+        // index of point i of the finest grid in the (MPI process-wide) arrays
+        int_idx_t glb(int_idx_t i) const
+        {
+          for (int d = 0; d < parent_t::n_dims; ++d) i[d] += this->mem->grid_size[d].first();
+          return i;
+        }
+
+        // the first (or last) point of the finest grid owned by the thread
+        int_idx_t own(const bool last) const
+        {
+          int_idx_t ret;
+          for (int d = 0; d < parent_t::n_dims; ++d)
+            ret[d] = (last ? this->ijk.ubound(d) : this->ijk.lbound(d)) - this->mem->grid_size[d].first();
+          return ret;
+        }
+
+        int_idx_t n_fine() const
+        {
+          int_idx_t ret;
+          for (int d = 0; d < parent_t::n_dims; ++d) ret[d] = this->mem->grid_size[d].length();
+          return ret;
+        }
+
+        // the coarse grids allocated in alloc_bcond()
+        void bind_levels()
+        {
+          auto &tmp = this->mem->tmp[__FILE__];
+          int_idx_t n = n_fine();
+          std::array<real_t, parent_t::n_dims> dijk = this->dijk;
+          for (std::size_t l = 4; l < tmp.size(); ++l)
+          {
+            auto &av = tmp[l];
+            level_t lv;
+            for (int d = 0; d < parent_t::n_dims; ++d)
+            {
+              lv.n[d] = av[0].extent(d);
+              lv.c[d] = lv.n[d] != n[d];
+              lv.dijk[d] = dijk[d] * (lv.c[d] ? 2 : 1);
+            }
+            lv.x.reference(av[0]);
+            lv.b.reference(av[1]);
+            lv.r.reference(av[2]);
+            lv.g.reference(av[3]);
+            for (int d = 0; d < parent_t::n_dims; ++d) lv.a.push_back(av[4 + d]);
+            lev.push_back(lv);
+            n = lv.n;
+            dijk = lv.dijk;
+          }
+          lev_bound = true;
+        }
+
+        // the operator coefficients on all grids and the parts of the coarse grids owned by the thread,
+        // recomputed together with those of lap() (see lap_coeff_init())
+        void mg_init(bool simple)
+        {
+          for (int d = 0; d < parent_t::n_dims; ++d)
+          {
+            for (int s = 0; s < 2; ++s)
+            {
+              int_idx_t fl(0);
+              fl[0] = d;
+              fl[1] = s;
+              cyc[d][s] = bcfl(fl) != 0;
+            }
+          }
+
+          if (!lev_bound) bind_levels();
+
+          int_idx_t lo = own(false), hi = own(true);
+          for (auto &lv : lev)
+          {
+            for (int d = 0; d < parent_t::n_dims; ++d)
+            {
+              if (!lv.c[d]) continue;
+              int I = crs(lo[d]), J = crs(hi[d]);
+              while (fst(I) < lo[d]) ++I;
+              while (fst(J + 1) <= hi[d]) ++J;
+              lo[d] = I;
+              hi[d] = J;
+            }
+            lv.lo = lo;
+            lv.hi = hi;
+          }
+
+          auto &coeff = this->lap_tmp;
+          for (int d = 0; d < parent_t::n_dims; ++d)
+          {
+            if (this->mem->G) coeff[d](this->ijk) = (*this->mem->G)(this->ijk);
+            else coeff[d](this->ijk) = 1;
+          }
+          if (!simple) this->normalize_vip(coeff);
+          this->mem->barrier();
+
+          const int_idx_t n = n_fine();
+          const auto G_at = [&](const int_idx_t &i) -> real_t { return this->mem->G ? (*this->mem->G)(glb(i)) : 1; };
+          for_box(own(false), own(true), [&](const int_idx_t &i)
+          {
+            real_t diag = 0;
+            for (int d = 0; d < parent_t::n_dims; ++d)
+            {
+              diag -= (
+                coeff[d](glb(nghbr(i, d, -1, n))) +
+                coeff[d](glb(nghbr(i, d,  1, n)))
+              ) / (4 * this->dijk[d] * this->dijk[d]);
+            }
+            dgnl(glb(i)) = diag / G_at(i);
+          });
+
+          if (lev.empty()) return;
+
+          for (int d = 0; d < parent_t::n_dims; ++d)
+            rstr(lev[0], n, [&](const int_idx_t &i) { return coeff[d](glb(i)); }, lev[0].a[d]);
+          rstr(lev[0], n, G_at, lev[0].g);
+          this->mem->barrier();
+
+          for (int l = 1; l < int(lev.size()); ++l)
+          {
+            const auto &lf = lev[l - 1];
+            for (int d = 0; d < parent_t::n_dims; ++d)
+              rstr(lev[l], lf.n, [&](const int_idx_t &i) { return lf.a[d](i); }, lev[l].a[d]);
+            rstr(lev[l], lf.n, [&](const int_idx_t &i) { return lf.g(i); }, lev[l].g);
+            this->mem->barrier();
+          }
+        }
+
+        void pressure_solver_loop_init(bool simple) final
+        {
+          if (this->lap_coeff_fresh) mg_init(simple);
+          if (!mg_krylov) return;
+
+          vcycle(simple);
+	  p_err[0](this->ijk) = q_err(this->ijk);
+	  lap_p_err[0](this->ijk) = this->lap(p_err[0], this->ijk, this->dijk, false, simple);
+        }
+
+        void pressure_solver_loop_body(bool simple) final
+        {
+          if (!mg_krylov)
+          {
+            vcycle(simple);
+            this->Phi(this->ijk) -= q_err(this->ijk);
+            this->err(this->ijk) -= this->lap(q_err, this->ijk, this->dijk, false, simple);
+
+            const real_t error = this->prs_reduce({}, this->ijk, &this->err)[0];
+            if (error <= this->err_tol) this->converged = true;
+            return;
+          }
+
+          for (int v = 0; v < k_iters; ++v)
+          {
+            // both scalar products within a single reduction
+            {
+              const auto sums = this->prs_reduce({{&lap_p_err[v], &lap_p_err[v]}, {&this->err, &lap_p_err[v]}}, this->ijk);
+              tmp_den[v] = sums[0];
+              if (tmp_den[v] != 0) beta = - sums[1] / tmp_den[v];
+            }
+            this->Phi(this->ijk) += beta * p_err[v](this->ijk);
+            this->err(this->ijk) += beta * lap_p_err[v](this->ijk);
+
+            vcycle(simple);
+            lap_q_err(this->ijk) = this->lap(q_err, this->ijk, this->dijk, false, simple);
+
+            // all the alpha coefficients and the error norm within a single reduction
+            {
+              std::vector<std::pair<const typename parent_t::arr_t*, const typename parent_t::arr_t*>> prods;
+              for (int l = 0; l <= v; ++l) prods.emplace_back(&lap_q_err, &lap_p_err[l]);
+              const auto sums = this->prs_reduce(prods, this->ijk, &this->err);
+
+              for (int l = 0; l <= v; ++l)
+              {
+                if (tmp_den[l] != 0)
+                  alpha[l] = - sums[l] / tmp_den[l];
+              }
+
+              const real_t error = sums[v + 1];
+              if (error <= this->err_tol) this->converged = true;
+            }
+
+            // unlike in gcrk, no further (costly) preconditioning once converged
+            if (this->converged) return;
+
+            const int w = v < (k_iters - 1) ? v + 1 : 0;
+            p_err[w](this->ijk) = q_err(this->ijk) + alpha[0] * p_err[0](this->ijk);
+            lap_p_err[w](this->ijk) = lap_q_err(this->ijk) + alpha[0] * lap_p_err[0](this->ijk);
+            for (int l = 1; l <= v; ++l)
+            {
+              p_err[w](this->ijk) += alpha[l] * p_err[l](this->ijk);
+              lap_p_err[w](this->ijk) += alpha[l] * lap_p_err[l](this->ijk);
+            }
+          }
+        }
+
+	public:
+
+	struct rt_params_t : parent_t::rt_params_t
+        {
+          int mg_sweeps = 2;     // number of pre- and post-smoothing (damped Jacobi) sweeps
+          int mg_levels = 0;     // maximal number of coarse grids (0 - as many as the grid size allows)
+          bool mg_krylov = true; // if false, V-cycles are iterated on their own (not as a GCR(k) preconditioner)
+        };
+
+	// ctor
+	mpdata_rhs_vip_prs_mg(
+	  typename parent_t::ctor_args_t args,
+	  const rt_params_t &p
+	) :
+	  parent_t(args, p),
+          mg_sweeps(p.mg_sweeps),
+          mg_krylov(p.mg_krylov),
+          beta(.25),
+          alpha(k_iters, 1.),
+          tmp_den(k_iters, 1.),
+	      q_err(args.mem->tmp[__FILE__][0][0]),
+	  lap_q_err(args.mem->tmp[__FILE__][0][1]),
+	        res(args.mem->tmp[__FILE__][0][2]),
+	       dgnl(args.mem->tmp[__FILE__][0][3]),
+	       bcfl(args.mem->tmp[__FILE__][3][0]),
+	      p_err(args.mem->tmp[__FILE__][1]),
+	  lap_p_err(args.mem->tmp[__FILE__][2])
+	{
+          assert(mg_sweeps > 0 && "params.mg_sweeps not positive?");
+        }
+
+	static void alloc(
+          typename parent_t::mem_t *mem,
+          const int &n_iters
+        ) {
+	  parent_t::alloc(mem, n_iters);
+	  parent_t::alloc_tmp_sclr(mem, __FILE__, 4); // q_err, lap_q_err, res, dgnl
+	  parent_t::alloc_tmp_sclr(mem, __FILE__, k_iters); // p_err
+	  parent_t::alloc_tmp_sclr(mem, __FILE__, k_iters); // lap_p_err
+
+          // flags marking the cyclic domain edges (set in alloc_bcond())
+          int_idx_t fl_shape(1);
+          fl_shape[0] = parent_t::n_dims;
+          fl_shape[1] = 2;
+          mem->tmp[__FILE__].push_back(new arrvec_t<typename parent_t::arr_t>());
+          mem->tmp[__FILE__].back().push_back(mem->old(new typename parent_t::arr_t(fl_shape)));
+          mem->tmp[__FILE__].back()[0] = 0;
+
+          mem->alloc_reduce(std::max(2, k_iters));
+	}
+
+        // the coarse grids, their sizes depending on which domain edges are cyclic
+	static void alloc_bcond(
+          typename parent_t::mem_t *mem,
+          const rt_params_t &p,
+          const std::array<std::array<bool, 2>, parent_t::n_dims> &cyclic
+        ) {
+          parent_t::alloc_bcond(mem, p, cyclic);
+
+          auto &bcfl = mem->tmp[__FILE__][3][0];
+          std::array<bool, parent_t::n_dims> restr;
+          for (int d = 0; d < parent_t::n_dims; ++d)
+          {
+            int_idx_t fl(0);
+            fl[0] = d;
+            for (int s = 0; s < 2; ++s)
+            {
+              fl[1] = s;
+              bcfl(fl) = cyclic[d][s];
+            }
+            restr[d] = !p.mg_krylov || cyclic[d][0] || cyclic[d][1];
+          }
+
+          const auto sizes = crs_sizes(mem->grid_size, restr);
+          const int n_lev = p.mg_levels > 0 ? std::min(p.mg_levels, int(sizes.size())) : int(sizes.size());
+          for (int l = 0; l < n_lev; ++l)
+          {
+            // x, b, r, g and a (one per dimension)
+            mem->tmp[__FILE__].push_back(new arrvec_t<typename parent_t::arr_t>());
+            for (int a = 0; a < 4 + parent_t::n_dims; ++a)
+              mem->tmp[__FILE__].back().push_back(mem->old(new typename parent_t::arr_t(sizes[l])));
+          }
+        }
+      };
+    } // namespace detail
+  } // namespace solvers
+} // namespace libmpdataxx
@@ -41,16 +41,15 @@ namespace libmpdataxx
         {
           this->lap_err(this->ijk) = this->lap(this->err, this->ijk, this->dijk, false, simple);
 
-          tmp_den = this->prs_sum(this->lap_err, this->lap_err, this->ijk);
-          if (tmp_den != 0) beta = - this->prs_sum(this->err, this->lap_err, this->ijk) / tmp_den;
+          // both scalar products within a single reduction
+          const auto sums = this->prs_reduce({{&lap_err, &lap_err}, {&this->err, &lap_err}}, this->ijk);
+          tmp_den = sums[0];
+          if (tmp_den != 0) beta = - sums[1] / tmp_den;
 
           this->Phi(this->ijk) += beta * this->err(this->ijk);
           this->err(this->ijk) += beta * this->lap_err(this->ijk);
 
-          real_t error = std::max(
-            std::abs(this->mem->max(this->rank, this->err(this->ijk))), 
-            std::abs(this->mem->min(this->rank, this->err(this->ijk)))
-          );
+          const real_t error = this->prs_reduce({}, this->ijk, &this->err)[0];
 
           if (error <= this->err_tol) this->converged = true;
         }
@@ -76,6 +75,7 @@ namespace libmpdataxx
         ) {
 	  parent_t::alloc(mem, n_iters);
 	  parent_t::alloc_tmp_sclr(mem, __FILE__, 1);
+          mem->alloc_reduce(2);
 	}
       }; 
     } // namespace detail
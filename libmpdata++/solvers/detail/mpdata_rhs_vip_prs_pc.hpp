@@ -7,7 +7,9 @@
   * @brief preconditioned conjugate residual pressure solver 
   *   (for more detailed discussion consult Smolarkiewicz & Szmelter 2011
   *    A Nonhydrostatic Unstructured-Mesh Soundproof Model for Simulation of Internal Gravity Waves
-  *    Acta Geophysica)
+  *    Acta Geophysica; for the line relaxation see e.g. Skamarock, Smolarkiewicz & Klemp 1997
+  *    Preconditioned Conjugate-Residual Solvers for Helmholtz Equations in Nonhydrostatic Models
+  *    Mon. Wea. Rev.)
   */
 
 #pragma once
@@ -18,6 +20,17 @@ namespace libmpdataxx
 {
   namespace solvers
   {
+    enum pc_prcnd_t
+    {
+      rchrdsn, // Richardson iterations
+      vlr      // vertical line relaxation (the part of the operator along the last dimension inverted exactly)
+    };
+
+    const std::map<pc_prcnd_t, std::string> prcnd2string = {
+      {rchrdsn, "rchrdsn"},
+      {vlr    , "vlr"    }
+    };
+
     namespace detail
     {
       template <class ct_params_t, int minhalo>
@@ -33,29 +46,132 @@ namespace libmpdataxx
         using ix = typename ct_params_t::ix;
 
 	const int pc_iters;
+        const pc_prcnd_t pc_prcnd;
 	real_t beta, alpha, tmp_den;
 
-	typename parent_t::arr_t p_err, q_err, lap_p_err, lap_q_err, pcnd_err;
+	typename parent_t::arr_t p_err, q_err, lap_p_err, lap_q_err, pcnd_err, tri_l, tri_w, tri_c;
+
+        // the part of the subdomain at index k along the last (vertical) dimension,
+        // optionally shifted by o along dimension d
+        idx_t<parent_t::n_dims> lvl(const int k, const int d = 0, const int o = 0) const
+        {
+          auto ret = this->ijk;
+          ret.lbound(parent_t::n_dims - 1) = k;
+          ret.ubound(parent_t::n_dims - 1) = k;
+          ret.lbound(d) += o;
+          ret.ubound(d) += o;
+          return ret;
+        }
+
+        // The vertical part of lap() couples every other level, i.e. at level k it reads
+        //   (a(k+1) (x(k+2) - x(k)) - a(k-1) (x(k) - x(k-2))) / (4 dz^2) / G
+        // with a being the coefficients from lap_coeff_init() and x mirrored about the edge levels.
+        // Together with the diagonal of the horizontal part it gives two tridiagonal systems per column
+        // (even and odd levels) solved exactly with the Thomas algorithm, level by level for all
+        // the columns of the subdomain at once. Here the elimination is done whenever the coefficients
+        // are recomputed, leaving the lower diagonal in tri_l, the inverses of the pivots in tri_w
+        // and the upper diagonal divided by the pivots in tri_c.
+        void vlr_init()
+        {
+          const int nz = parent_t::n_dims - 1;
+          const int k0 = this->mem->grid_size[nz].first(), k1 = this->mem->grid_size[nz].last();
+
+          const auto &coeff = this->lap_coeff;
+
+          const real_t cz = real_t(1) / (4 * pow2(this->dijk[nz]));
+          for (int k = k0; k <= k1; ++k)
+          {
+            const auto s = lvl(k);
+
+            // lower and upper diagonal (mirrored about the edge levels)
+            if (k == k1) tri_l(s) = 2 * cz * coeff[nz](lvl(k - 1));
+            else if (k - k0 >= 2) tri_l(s) = cz * coeff[nz](lvl(k - 1));
+            else tri_l(s) = real_t(0);
+
+            if (k == k0) tri_c(s) = 2 * cz * coeff[nz](lvl(k + 1));
+            else if (k1 - k >= 2) tri_c(s) = cz * coeff[nz](lvl(k + 1));
+            else tri_c(s) = real_t(0);
+
+            // diagonal (horizontal part included, the coefficients beyond the zero-flux edges
+            // being the negated ones from within the domain)
+            tri_w(s) = - tri_l(s) - tri_c(s);
+            for (int d = 0; d < nz; ++d)
+              tri_w(s) -= (abs(coeff[d](lvl(k, d, -1))) + abs(coeff[d](lvl(k, d, 1)))) / (4 * pow2(this->dijk[d]));
+
+            if (this->mem->G)
+            {
+              tri_l(s) /= (*this->mem->G)(s);
+              tri_c(s) /= (*this->mem->G)(s);
+              tri_w(s) /= (*this->mem->G)(s);
+            }
+
+            // forward elimination
+            if (k - k0 >= 2) tri_w(s) -= tri_l(s) * tri_c(lvl(k - 2));
+            tri_w(s) = real_t(1) / tri_w(s);
+            tri_c(s) *= tri_w(s);
+          }
+        }
+
+        // in-place solution of the tridiagonal systems factorised in vlr_init()
+        void vlr_solve(typename parent_t::arr_t &x)
+        {
+          const int nz = parent_t::n_dims - 1;
+          const int k0 = this->mem->grid_size[nz].first(), k1 = this->mem->grid_size[nz].last();
+
+          for (int k = k0; k <= k1; ++k)
+          {
+            const auto s = lvl(k);
+            if (k - k0 >= 2) x(s) -= tri_l(s) * x(lvl(k - 2));
+            x(s) *= tri_w(s);
+          }
+          for (int k = k1 - 2; k >= k0; --k)
+          {
+            x(lvl(k)) -= tri_c(lvl(k)) * x(lvl(k + 2));
+          }
+        }
 
-	void precond(bool simple)  //Richardson scheme
+	void precond(bool simple)
 	{
+	  assert(pc_iters >= 0 && pc_iters < 10 && "params.pc_iters not specified?");
+
+          if (pc_prcnd == vlr) 
+          {
+            // line Jacobi iterations
+            q_err(this->ijk) = this->err(this->ijk);
+            vlr_solve(q_err);
+            for (int it=0; it<pc_iters; it++)
+            {
+              pcnd_err(this->ijk) = this->err(this->ijk) - this->lap(this->q_err, this->ijk, this->dijk, false, simple);
+              this->mem->nghbr_barrier(this->rank); // q_err read by the neighbours in lap()
+              vlr_solve(pcnd_err);
+              q_err(this->ijk) += pcnd_err(this->ijk);
+            }
+            return;
+          }
+
+          //Richardson scheme
+
 	  //initail q_err for preconditioner
 	  q_err(this->ijk) = real_t(0);
 
-	  //initail preconditioner error   
-	  this->pcnd_err(this->ijk) = this->lap(this->q_err, this->ijk, this->dijk, false, simple) - this->err(this->ijk);
+	  //initail preconditioner error (lap(q_err) vanishing)
+	  this->pcnd_err(this->ijk) = - this->err(this->ijk);
 	    //TODO does it change with non_const density?
 	  
-	  assert(pc_iters >= 0 && pc_iters < 10 && "params.pc_iters not specified?");
 	  for (int it=0; it<=pc_iters; it++)
 	  {
 	    q_err(this->ijk)    += real_t(.25) * pcnd_err(this->ijk);
-	    pcnd_err(this->ijk) += real_t(.25) * this->lap(this->pcnd_err, this->ijk, this->dijk);
+	    // lap() reads pcnd_err around each point (also from the neighbouring subdomains),
+	    // hence evaluated into lap_q_err (unused until after precond()) before pcnd_err is updated
+	    lap_q_err(this->ijk) = this->lap(this->pcnd_err, this->ijk, this->dijk, false, simple);
+	    this->mem->nghbr_barrier(this->rank);
+	    pcnd_err(this->ijk) += real_t(.25) * lap_q_err(this->ijk);
 	  }
 	}
 
         void pressure_solver_loop_init(bool simple) final
         {
+          if (pc_prcnd == vlr && this->lap_coeff_fresh) vlr_init();
 	  precond(simple);
 	  p_err(this->ijk) = q_err(this->ijk);
 	  this->lap_p_err(this->ijk) = this->lap(this->p_err, this->ijk, this->dijk, false, simple);
@@ -63,24 +179,28 @@ namespace libmpdataxx
 
         void pressure_solver_loop_body(bool simple) final
         {
-          tmp_den = this->prs_sum(lap_p_err, lap_p_err, this->ijk);
-          if (tmp_den != 0) beta = -this->prs_sum(this->err, lap_p_err, this->ijk) / tmp_den;
+          // both scalar products within a single reduction
+          {
+            const auto sums = this->prs_reduce({{&lap_p_err, &lap_p_err}, {&this->err, &lap_p_err}}, this->ijk);
+            tmp_den = sums[0];
+            if (tmp_den != 0) beta = - sums[1] / tmp_den;
+          }
  
           this->Phi(this->ijk) += beta * p_err(this->ijk);
           this->err(this->ijk) += beta * lap_p_err(this->ijk);
 
-          real_t error = std::max(
-            std::abs(this->mem->max(this->rank, this->err(this->ijk))), 
-            std::abs(this->mem->min(this->rank, this->err(this->ijk)))
-          );
-
-          if (error <= this->err_tol) this->converged = true;
-
-          precond();
+          precond(simple);
 
           this->lap_q_err(this->ijk) = this->lap(this->q_err, this->ijk, this->dijk, false, simple);
 
-          if (tmp_den != 0) alpha = -this->prs_sum(lap_q_err, lap_p_err, this->ijk) / tmp_den;
+          // alpha and the error norm within a single reduction (err is not modified by the preconditioner)
+          {
+            const auto sums = this->prs_reduce({{&lap_q_err, &lap_p_err}}, this->ijk, &this->err);
+            if (tmp_den != 0) alpha = - sums[0] / tmp_den;
+
+            const real_t error = sums[1];
+            if (error <= this->err_tol) this->converged = true;
+          }
 
           p_err(this->ijk) *= alpha;
           p_err(this->ijk) += q_err(this->ijk);  
@@ -91,7 +211,11 @@ namespace libmpdataxx
 
 	public:
 
-	struct rt_params_t : parent_t::rt_params_t { int pc_iters; };
+	struct rt_params_t : parent_t::rt_params_t 
+        { 
+          int pc_iters; 
+          pc_prcnd_t pc_prcnd = rchrdsn;
+        };
 
 	// ctor
 	mpdata_rhs_vip_prs_pc(
@@ -100,6 +224,7 @@ namespace libmpdataxx
 	) :
 	  parent_t(args, p),
 	  pc_iters(p.pc_iters),
+          pc_prcnd(p.pc_prcnd),
           beta(.25),
           alpha(1.),
           tmp_den(1.),
@@ -107,15 +232,27 @@ namespace libmpdataxx
 	  lap_q_err(args.mem->tmp[__FILE__][0][1]),
 	      p_err(args.mem->tmp[__FILE__][0][2]),
 	      q_err(args.mem->tmp[__FILE__][0][3]),
-	   pcnd_err(args.mem->tmp[__FILE__][0][4])
-	{}
+	   pcnd_err(args.mem->tmp[__FILE__][0][4]),
+	      tri_l(args.mem->tmp[__FILE__][0][5]),
+	      tri_w(args.mem->tmp[__FILE__][0][6]),
+	      tri_c(args.mem->tmp[__FILE__][0][7])
+	{
+          const int nz = parent_t::n_dims - 1;
+          if (
+            pc_prcnd == vlr && (
+              this->ijk.lbound(nz) != this->mem->grid_size[nz].first() || 
+              this->ijk.ubound(nz) != this->mem->grid_size[nz].last()
+            )
+          ) throw std::runtime_error("vertical line relaxation requires the domain not to be decomposed along the last dimension");
+        }
 
 	static void alloc(
           typename parent_t::mem_t *mem, 
           const int &n_iters
         ) {
 	  parent_t::alloc(mem, n_iters);
-	  parent_t::alloc_tmp_sclr(mem, __FILE__, 5);
+	  parent_t::alloc_tmp_sclr(mem, __FILE__, 8);
+          mem->alloc_reduce(2);
 	}
       }; 
     } // namespcae detail
@@ -0,0 +1,135 @@
+/**
+  * @file
+  * @copyright University of Warsaw
+  * @section LICENSE
+  * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+  *
+  * @brief pipelined conjugate residual pressure solver: the iterates of the conjugate residual
+  *   scheme (cf. mpdata_rhs_vip_prs_gcrk.hpp with k_iters = 1), with the scalar products
+  *   of each iteration computed in a single reduction overlapped with the Laplacian
+  *   (cf. Ghysels & Vanroose 2014, Parallel Computing 40, Hiding global synchronization
+  *   latency in the preconditioned Conjugate Gradient algorithm)
+  */
+
+#pragma once
+#include <libmpdata++/solvers/detail/mpdata_rhs_vip_prs_common.hpp>
+
+namespace libmpdataxx
+{
+  namespace solvers
+  {
+    namespace detail
+    {
+      template <class ct_params_t, int minhalo>
+      class mpdata_rhs_vip_prs_plcr : public detail::mpdata_rhs_vip_prs_common<ct_params_t, minhalo>
+      {
+        public:
+
+	using real_t = typename ct_params_t::real_t;
+
+        private:
+
+	using parent_t = detail::mpdata_rhs_vip_prs_common<ct_params_t, minhalo>;
+        using ix = typename ct_params_t::ix;
+
+        // With err, the search direction p and (with A denoting lap()) the vectors
+        // q = A p, s = A err, w = A q and u = A s kept up to date with recurrences,
+        // all the scalar products needed in an iteration, i.e. (err, q), (s, q), (w, q) and (q, q),
+        // involve vectors known before the only Laplacian of the iteration, z = A w, is computed:
+        //   beta = - (err, q) / (q, q), alpha = - ((s, q) + beta (w, q)) / (q, q),
+        //   Phi += beta p, err += beta q, s += beta w, u += beta z,
+        //   p = err + alpha p, q = s + alpha q, w = u + alpha w.
+        // As the recurrences accumulate round-off errors, once converged the error is recomputed
+        // from its initial value and the change of Phi, and the iterations are restarted if needed.
+
+	typename parent_t::arr_t p_err, lap_p_err, lap_err, lap2_p_err, lap2_err, lap3_p_err, err_0, Phi_0;
+
+        void restart(bool simple)
+        {
+	  p_err(this->ijk) = this->err(this->ijk);
+	  lap_p_err(this->ijk) = this->lap(p_err, this->ijk, this->dijk, false, simple);
+          lap_err(this->ijk) = lap_p_err(this->ijk);
+	  lap2_p_err(this->ijk) = this->lap(lap_p_err, this->ijk, this->dijk, false, simple);
+          lap2_err(this->ijk) = lap2_p_err(this->ijk);
+        }
+
+        void pressure_solver_loop_init(bool simple) final
+        {
+          err_0(this->ijk) = this->err(this->ijk);
+          Phi_0(this->ijk) = this->Phi(this->ijk);
+          restart(simple);
+        }
+
+        void pressure_solver_loop_body(bool simple) final
+        {
+          // all the scalar products and the error norm within a single reduction ...
+          this->prs_reduce_post({
+            {&this->err, &lap_p_err},
+            {&lap_err, &lap_p_err},
+            {&lap2_p_err, &lap_p_err},
+            {&lap_p_err, &lap_p_err}
+          }, this->ijk, &this->err);
+
+          // ... awaited after the Laplacian
+          lap3_p_err(this->ijk) = this->lap(lap2_p_err, this->ijk, this->dijk, false, simple);
+          const auto sums = this->prs_reduce_wait(4, true);
+
+          if (sums[4] <= this->err_tol)
+          {
+            // the error computed directly (lap3_p_err reused as a temporary array)
+            lap3_p_err(this->ijk) = this->Phi(this->ijk) - Phi_0(this->ijk);
+            this->err(this->ijk) = err_0(this->ijk) + this->lap(lap3_p_err, this->ijk, this->dijk, false, simple);
+            const real_t error = this->prs_reduce({}, this->ijk, &this->err)[0];
+            if (error <= this->err_tol) this->converged = true;
+            else restart(simple);
+            return;
+          }
+
+          if (sums[3] == 0) return;
+          const real_t
+            beta = - sums[0] / sums[3],
+            alpha = - (sums[1] + beta * sums[2]) / sums[3];
+
+          this->Phi(this->ijk) += beta * p_err(this->ijk);
+          this->err(this->ijk) += beta * lap_p_err(this->ijk);
+          lap_err(this->ijk) += beta * lap2_p_err(this->ijk);
+          lap2_err(this->ijk) += beta * lap3_p_err(this->ijk);
+
+          p_err(this->ijk) = this->err(this->ijk) + alpha * p_err(this->ijk);
+          lap_p_err(this->ijk) = lap_err(this->ijk) + alpha * lap_p_err(this->ijk);
+          lap2_p_err(this->ijk) = lap2_err(this->ijk) + alpha * lap2_p_err(this->ijk);
+        }
+
+	public:
+
+	struct rt_params_t : parent_t::rt_params_t { };
+
+	// ctor
+	mpdata_rhs_vip_prs_plcr(
+	  typename parent_t::ctor_args_t args,
+	  const rt_params_t &p
+	) :
+	  parent_t(args, p),
+	       p_err(args.mem->tmp[__FILE__][0][0]),
+	   lap_p_err(args.mem->tmp[__FILE__][0][1]),
+	     lap_err(args.mem->tmp[__FILE__][0][2]),
+	  lap2_p_err(args.mem->tmp[__FILE__][0][3]),
+	    lap2_err(args.mem->tmp[__FILE__][0][4]),
+	  lap3_p_err(args.mem->tmp[__FILE__][0][5]),
+	       err_0(args.mem->tmp[__FILE__][0][6]),
+	       Phi_0(args.mem->tmp[__FILE__][0][7])
+	{}
+
+	static void alloc(
+          typename parent_t::mem_t *mem,
+          const int &n_iters
+        ) {
+	  parent_t::alloc(mem, n_iters);
+	  parent_t::alloc_tmp_sclr(mem, __FILE__, 8);
+          mem->alloc_reduce(1);
+          mem->alloc_reduce_pipe(4);
+	}
+      };
+    } // namespace detail
+  } // namespace solvers
+} // namespace libmpdataxx
@@ -53,6 +53,15 @@ namespace libmpdataxx
         std::array<rng_t, ct_params_t::n_dims> ijkm;
         real_t cdrag;
 
+        void set_subdomain(const idx_t<ct_params_t::n_dims> &ijk_new)
+        {
+          parent_t::set_subdomain(ijk_new);
+          for (int d = 0; d < ct_params_t::n_dims; ++d)
+          {
+            ijkm[d] = rng_t(this->ijk[d].first() - 1, this->ijk[d].last());
+          }
+        }
+
         virtual void multiply_sgs_visc() = 0;
 
         virtual void calc_drag_cmpct()
@@ -90,9 +99,7 @@ namespace libmpdataxx
           using ix = typename ct_params_t::ix;
           using namespace arakawa_c;
 
-          // TODO: get rid of superfluous barriers
-          for (auto& vip : this->vips())
-            this->xchng_sclr(vip, this->ijk, 1);
+          this->xchng_sclr(this->vips(), this->ijk, 1);
           
           if (static_cast<stress_diff_t>(ct_params_t::stress_diff) == compact)
           {
@@ -144,11 +151,7 @@ namespace libmpdataxx
             // multiply deformation tensor by sgs viscosity to obtain stress tensor
             multiply_sgs_visc();
             
-            // TODO: get rid of superfluous barriers
-            for (auto& t : tau)
-            {
-              this->xchng_sclr(t, this->ijk);
-            }
+            this->xchng_sclr(tau, this->ijk);
             // calculate elements of stress tensor divergence
             formulae::stress::calc_stress_div<ct_params_t::n_dims>(drv, tau, this->ijk, this->dijk);
 
@@ -31,16 +31,23 @@ namespace libmpdataxx
 
 	protected:
 
-	const rng_t i; //TODO: to be removed
+	rng_t i; //TODO: to be removed
 
         // generic field used for various statistics (currently Courant number and divergence)
         typename parent_t::arr_t &stat_field; // TODO: should be in solver common but cannot be allocated there ?
 
+        void set_subdomain(const idx_t<1> &ijk_new)
+        {
+          parent_t::set_subdomain(ijk_new);
+          i = this->ijk[0];
+        }
+
         virtual void xchng_sclr(typename parent_t::arr_t &arr, const bool deriv = false) final // for a given array
         {
-          this->mem->barrier();
+          this->xchng_sclr_stats(arr);
+          this->mem->nghbr_barrier(this->rank);
           for (auto &bc : this->bcs[0]) bc->fill_halos_sclr(arr, deriv);
-          this->mem->barrier();
+          this->mem->nghbr_barrier(this->rank);
         }
 
         // no pressure solver in 1D but this function needs to be present for dimension independant code,
@@ -52,12 +59,15 @@ namespace libmpdataxx
 
 	void xchng(int e) final
 	{
-          xchng_sclr(this->mem->psi[e][ this->n[e]]);
+          auto &psi = this->mem->psi[e][ this->n[e]];
+          if (this->halo_valid(psi, this->halo)) return;
+          xchng_sclr(psi);
+          this->mem->halo_validate(this->rank, psi, this->halo);
 	}
 
         void xchng_vctr_alng(arrvec_t<typename parent_t::arr_t> &arrvec, const bool ad = false, const bool cyclic = false) final
         {
-          this->mem->barrier();
+          this->mem->nghbr_barrier(this->rank);
           if (!cyclic)
           {
             for (auto &bc : this->bcs[0]) bc->fill_halos_vctr_alng(arrvec, ad); 
@@ -66,7 +76,7 @@ namespace libmpdataxx
           {
             for (auto &bc : this->bcs[0]) bc->fill_halos_vctr_alng_cyclic(arrvec, ad);
           }
-          this->mem->barrier();
+          this->mem->nghbr_barrier(this->rank);
         }
 
         real_t courant_number(const arrvec_t<typename parent_t::arr_t> &arrvec) final
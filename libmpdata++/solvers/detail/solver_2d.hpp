@@ -32,32 +32,65 @@ namespace libmpdataxx
 
 	protected:
       
-	const rng_t i, j; // TODO: to be removed
+	rng_t i, j; // TODO: to be removed
 
         // generic field used for various statistics (currently Courant number and divergence)
         typename parent_t::arr_t &stat_field; // TODO: should be in solver common but cannot be allocated there ?
 
+        void set_subdomain(const idx_t<2> &ijk_new)
+        {
+          parent_t::set_subdomain(ijk_new);
+          i = this->ijk[0];
+          j = this->ijk[1];
+        }
+
 	virtual void xchng_sclr(typename parent_t::arr_t &arr,
                         const idx_t<2> &range_ijk,
                         const int ext = 0,
                         const bool deriv = false
         ) final // for a given array
 	{
-          const auto range_ijk_0__ext = this->extend_range(range_ijk[0], ext);
-          this->mem->barrier();
-          for (auto &bc : this->bcs[0]) bc->fill_halos_sclr(arr, range_ijk[1]^ext, deriv);
+          const auto range_ijk_0__ext = this->extend_range(0, range_ijk[0], ext);
+          const auto range_ijk_1__ext = this->extend_range(1, range_ijk[1], ext);
+          this->xchng_sclr_stats(arr);
+          this->mem->nghbr_barrier(this->rank);
+          for (auto &bc : this->bcs[0]) bc->fill_halos_sclr(arr, range_ijk_1__ext, deriv);
+          this->xchng_dim_barrier();
 	  for (auto &bc : this->bcs[1]) bc->fill_halos_sclr(arr, range_ijk_0__ext, deriv);
-          this->mem->barrier();
+          this->mem->nghbr_barrier(this->rank);
 	}
 
+        // several scalar fields exchanged within a single set of barriers
+        void xchng_sclr(arrvec_t<typename parent_t::arr_t> &arrvec,
+                        const idx_t<2> &range_ijk,
+                        const int ext = 0,
+                        const bool deriv = false
+        ) 
+        {
+          const auto range_ijk_0__ext = this->extend_range(0, range_ijk[0], ext);
+          const auto range_ijk_1__ext = this->extend_range(1, range_ijk[1], ext);
+          for (auto &arr : arrvec) this->xchng_sclr_stats(arr);
+          this->mem->nghbr_barrier(this->rank);
+          for (auto &arr : arrvec) 
+            for (auto &bc : this->bcs[0]) bc->fill_halos_sclr(arr, range_ijk_1__ext, deriv);
+          this->xchng_dim_barrier();
+          for (auto &arr : arrvec) 
+	    for (auto &bc : this->bcs[1]) bc->fill_halos_sclr(arr, range_ijk_0__ext, deriv);
+          this->mem->nghbr_barrier(this->rank);
+          this->mem->xchng_stats[this->rank].barriers_saved += (arrvec.size() - 1) * this->xchng_sclr_barriers();
+        }
+
 	void xchng(int e) final
 	{
-          this->xchng_sclr(this->mem->psi[e][ this->n[e]], this->ijk, this->halo);
+          auto &psi = this->mem->psi[e][ this->n[e]];
+          if (this->halo_valid(psi, this->halo)) return;
+          this->xchng_sclr(psi, this->ijk, this->halo);
+          this->mem->halo_validate(this->rank, psi, this->halo);
 	}
 
         void xchng_vctr_alng(arrvec_t<typename parent_t::arr_t> &arrvec, const bool ad = false, const bool cyclic = false) final
         {
-          this->mem->barrier();
+          this->mem->nghbr_barrier(this->rank);
           if (!cyclic)
           {
             for (auto &bc : this->bcs[0]) bc->fill_halos_vctr_alng(arrvec, j, ad);
@@ -69,15 +102,27 @@ namespace libmpdataxx
             for (auto &bc : this->bcs[1]) bc->fill_halos_vctr_alng_cyclic(arrvec, i, ad);
           }
           // TODO: open bc nust be last!!!
-          this->mem->barrier();
+          this->mem->nghbr_barrier(this->rank);
         }
         
         virtual void xchng_flux(arrvec_t<typename parent_t::arr_t> &arrvec) final
         {
-          this->mem->barrier();
+          this->mem->nghbr_barrier(this->rank);
           for (auto &bc : this->bcs[0]) bc->fill_halos_flux(arrvec, j);
           for (auto &bc : this->bcs[1]) bc->fill_halos_flux(arrvec, i);
-          this->mem->barrier();
+          this->mem->nghbr_barrier(this->rank);
+        }
+
+        // fluxes of several equations exchanged within a single set of barriers
+        void xchng_flux(const std::vector<arrvec_t<typename parent_t::arr_t>*> &flxs)
+        {
+          this->mem->nghbr_barrier(this->rank);
+          for (auto &flx : flxs)
+          {
+            for (auto &bc : this->bcs[0]) bc->fill_halos_flux(*flx, j);
+            for (auto &bc : this->bcs[1]) bc->fill_halos_flux(*flx, i);
+          }
+          this->mem->nghbr_barrier(this->rank);
         }
         
         virtual void xchng_sgs_div(
@@ -85,10 +130,10 @@ namespace libmpdataxx
           const idx_t<2> &range_ijk
         ) final
         {
-          this->mem->barrier();
+          this->mem->nghbr_barrier(this->rank);
           for (auto &bc : this->bcs[0]) bc->fill_halos_sgs_div(arr, range_ijk[1]^h);
           for (auto &bc : this->bcs[1]) bc->fill_halos_sgs_div(arr, range_ijk[0]);
-          this->mem->barrier();
+          this->mem->nghbr_barrier(this->rank);
         }
         
         virtual void xchng_sgs_vctr(arrvec_t<typename parent_t::arr_t> &av,
@@ -96,10 +141,10 @@ namespace libmpdataxx
                             const idx_t<2> &range_ijk
         ) final
         {
-          this->mem->barrier();
+          this->mem->nghbr_barrier(this->rank);
           for (auto &bc : this->bcs[0]) bc->fill_halos_sgs_vctr(av, b, range_ijk[1]);
           for (auto &bc : this->bcs[1]) bc->fill_halos_sgs_vctr(av, b, range_ijk[0]);
-          this->mem->barrier();
+          this->mem->nghbr_barrier(this->rank);
         }
 
         virtual void xchng_sgs_tnsr_diag(arrvec_t<typename parent_t::arr_t> &av,
@@ -108,10 +153,10 @@ namespace libmpdataxx
 	                                 const idx_t<2> &range_ijk
         ) final
         {
-          this->mem->barrier();
+          this->mem->nghbr_barrier(this->rank);
           for (auto &bc : this->bcs[0]) bc->fill_halos_sgs_tnsr(av, w, vip_div, range_ijk[1], this->dijk[0]);
           for (auto &bc : this->bcs[1]) bc->fill_halos_sgs_tnsr(av, w, vip_div, range_ijk[0], this->dijk[1]);
-          this->mem->barrier();
+          this->mem->nghbr_barrier(this->rank);
         }
 
         virtual void xchng_sgs_tnsr_offdiag(arrvec_t<typename parent_t::arr_t> &av,
@@ -122,10 +167,10 @@ namespace libmpdataxx
         {
 
           // off-diagonal components of stress tensor are treated the same as a vector
-          this->mem->barrier();
+          this->mem->nghbr_barrier(this->rank);
           for (auto &bc : this->bcs[0]) bc->fill_halos_sgs_vctr(av, bv[0], range_ijkm[1], 2);
 	  for (auto &bc : this->bcs[1]) bc->fill_halos_sgs_vctr(av, bv[0], range_ijkm[0], 1);
-          this->mem->barrier();
+          this->mem->nghbr_barrier(this->rank);
         }
 
         virtual void xchng_vctr_nrml(
@@ -136,19 +181,20 @@ namespace libmpdataxx
         ) final
         {
 
-          const auto range_ijk_0__ext_h = this->extend_range(range_ijk[0], ext, h);
-          this->mem->barrier();
+          const auto range_ijk_0__ext_h = this->extend_range(0, range_ijk[0], ext, h);
+          const auto range_ijk_1__ext_h = this->extend_range(1, range_ijk[1], ext, h);
+          this->mem->nghbr_barrier(this->rank);
           if (!cyclic)
           {
             for (auto &bc : this->bcs[1]) bc->fill_halos_vctr_nrml(arrvec[0], range_ijk_0__ext_h);
-            for (auto &bc : this->bcs[0]) bc->fill_halos_vctr_nrml(arrvec[1], range_ijk[1]^ext^h);
+            for (auto &bc : this->bcs[0]) bc->fill_halos_vctr_nrml(arrvec[1], range_ijk_1__ext_h);
           }
           else
           {
             for (auto &bc : this->bcs[1]) bc->fill_halos_vctr_nrml_cyclic(arrvec[0], range_ijk_0__ext_h);
-            for (auto &bc : this->bcs[0]) bc->fill_halos_vctr_nrml_cyclic(arrvec[1], range_ijk[1]^ext^h);
+            for (auto &bc : this->bcs[0]) bc->fill_halos_vctr_nrml_cyclic(arrvec[1], range_ijk_1__ext_h);
           }
-          this->mem->barrier();
+          this->mem->nghbr_barrier(this->rank);
         }
 
         virtual void xchng_pres(
@@ -157,11 +203,14 @@ namespace libmpdataxx
           const int ext = 0
         ) final
         {
-          const auto range_ijk_0__ext = this->extend_range(range_ijk[0], ext);
-          this->mem->barrier();
-          for (auto &bc : this->bcs[0]) bc->fill_halos_pres(arr, range_ijk[1]^ext);
+          const auto range_ijk_0__ext = this->extend_range(0, range_ijk[0], ext);
+          const auto range_ijk_1__ext = this->extend_range(1, range_ijk[1], ext);
+          this->xchng_sclr_stats(arr);
+          this->mem->nghbr_barrier(this->rank);
+          for (auto &bc : this->bcs[0]) bc->fill_halos_pres(arr, range_ijk_1__ext);
+          this->xchng_dim_barrier();
           for (auto &bc : this->bcs[1]) bc->fill_halos_pres(arr, range_ijk_0__ext);
-          this->mem->barrier();
+          this->mem->nghbr_barrier(this->rank);
         }
 
         virtual void set_edges(
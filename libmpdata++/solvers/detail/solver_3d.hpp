@@ -32,32 +32,104 @@ namespace libmpdataxx
 
 	protected:
 
-	const rng_t i, j, k; // TODO: we have ijk in solver_common - could it be removed?
+	rng_t i, j, k; // TODO: we have ijk in solver_common - could it be removed?
 
         // generic field used for various statistics (currently Courant number and divergence)
         typename parent_t::arr_t &stat_field; // TODO:/: should be in solver common but cannot be allocated there ?
 
+        void set_subdomain(const idx_t<3> &ijk_new)
+        {
+          parent_t::set_subdomain(ijk_new);
+          i = this->ijk[0];
+          j = this->ijk[1];
+          k = this->ijk[2];
+        }
+
 	virtual void xchng_sclr(typename parent_t::arr_t &arr,
 	               const idx_t<3> &range_ijk,
                        const int ext = 0,
                        const bool deriv = false
         ) final // for a given array
 	{
-          const auto range_ijk_0__ext = this->extend_range(range_ijk[0], ext);
-          this->mem->barrier();
-          for (auto &bc : this->bcs[0]) bc->fill_halos_sclr(arr, range_ijk[1]^ext, range_ijk[2]^ext, deriv);
-	  for (auto &bc : this->bcs[1]) bc->fill_halos_sclr(arr, range_ijk[2]^ext, range_ijk_0__ext, deriv);
-	  for (auto &bc : this->bcs[2]) bc->fill_halos_sclr(arr, range_ijk_0__ext, range_ijk[1]^ext, deriv);
-          this->mem->barrier();
+          this->xchng_sclr_stats(arr);
+          this->mem->nghbr_barrier(this->rank);
+          xchng_sclr_fill(arr, range_ijk, ext, deriv);
 	}
+
+        // the part of xchng_sclr() done once the neighbouring subdomains are ready
+        void xchng_sclr_fill(typename parent_t::arr_t &arr,
+                             const idx_t<3> &range_ijk,
+                             const int ext,
+                             const bool deriv
+        )
+        {
+          const auto range_ijk_0__ext = this->extend_range(0, range_ijk[0], ext);
+          const auto range_ijk_1__ext = this->extend_range(1, range_ijk[1], ext);
+          const auto range_ijk_2__ext = this->extend_range(2, range_ijk[2], ext);
+          for (auto &bc : this->bcs[0]) bc->fill_halos_sclr(arr, range_ijk_1__ext, range_ijk_2__ext, deriv);
+          this->xchng_dim_barrier();
+	  for (auto &bc : this->bcs[1]) bc->fill_halos_sclr(arr, range_ijk_2__ext, range_ijk_0__ext, deriv);
+          this->xchng_dim_barrier();
+	  for (auto &bc : this->bcs[2]) bc->fill_halos_sclr(arr, range_ijk_0__ext, range_ijk_1__ext, deriv);
+          this->mem->nghbr_barrier(this->rank);
+        }
+
+        // several scalar fields exchanged within a single set of barriers
+	void xchng_sclr(arrvec_t<typename parent_t::arr_t> &arrvec,
+	                const idx_t<3> &range_ijk,
+                        const int ext = 0,
+                        const bool deriv = false
+        )
+	{
+          const auto range_ijk_0__ext = this->extend_range(0, range_ijk[0], ext);
+          const auto range_ijk_1__ext = this->extend_range(1, range_ijk[1], ext);
+          const auto range_ijk_2__ext = this->extend_range(2, range_ijk[2], ext);
+          for (auto &arr : arrvec) this->xchng_sclr_stats(arr);
+          this->mem->nghbr_barrier(this->rank);
+          for (auto &arr : arrvec) 
+            for (auto &bc : this->bcs[0]) bc->fill_halos_sclr(arr, range_ijk_1__ext, range_ijk_2__ext, deriv);
+          this->xchng_dim_barrier();
+          for (auto &arr : arrvec) 
+	    for (auto &bc : this->bcs[1]) bc->fill_halos_sclr(arr, range_ijk_2__ext, range_ijk_0__ext, deriv);
+          this->xchng_dim_barrier();
+          for (auto &arr : arrvec) 
+	    for (auto &bc : this->bcs[2]) bc->fill_halos_sclr(arr, range_ijk_0__ext, range_ijk_1__ext, deriv);
+          this->mem->nghbr_barrier(this->rank);
+          this->mem->xchng_stats[this->rank].barriers_saved += (arrvec.size() - 1) * this->xchng_sclr_barriers();
+	}
+
 	void xchng(int e) final
 	{
-	  this->xchng_sclr(this->mem->psi[e][ this->n[e]], this->ijk, this->halo);
+          auto &psi = this->mem->psi[e][ this->n[e]];
+          if (this->halo_valid(psi, this->halo)) return;
+          this->xchng_sclr(psi, this->ijk, this->halo);
+          this->mem->halo_validate(this->rank, psi, this->halo);
 	}
 
+        // split-phase version of xchng(e): xchng_begin() only signals that the subdomain's own data 
+        // are ready and returns false if halos are valid anyway, xchng_end() waits for the neighbours
+        // and fills the halos; computations not involving halos may be done in between
+        // (with a global barrier instead of nghbr_sync, all the waiting is done in xchng_end())
+        bool xchng_begin(int e)
+        {
+          auto &psi = this->mem->psi[e][ this->n[e]];
+          if (this->halo_valid(psi, this->halo)) return false;
+          this->mem->nghbr_arrive(this->rank);
+          return true;
+        }
+
+        void xchng_end(int e)
+        {
+          auto &psi = this->mem->psi[e][ this->n[e]];
+          this->xchng_sclr_stats(psi);
+          this->mem->nghbr_wait(this->rank);
+          xchng_sclr_fill(psi, this->ijk, this->halo, false);
+          this->mem->halo_validate(this->rank, psi, this->halo);
+        }
+
         void xchng_vctr_alng(arrvec_t<typename parent_t::arr_t> &arrvec, const bool ad = false, const bool cyclic = false) final
         {
-          this->mem->barrier();
+          this->mem->nghbr_barrier(this->rank);
           if (!cyclic)
           {
             for (auto &bc : this->bcs[0]) bc->fill_halos_vctr_alng(arrvec, j, k, ad); 
@@ -70,27 +142,39 @@ namespace libmpdataxx
             for (auto &bc : this->bcs[1]) bc->fill_halos_vctr_alng_cyclic(arrvec, k, i, ad); 
             for (auto &bc : this->bcs[2]) bc->fill_halos_vctr_alng_cyclic(arrvec, i, j, ad);
           }
-          this->mem->barrier();
+          this->mem->nghbr_barrier(this->rank);
         }
         
         virtual void xchng_flux(arrvec_t<typename parent_t::arr_t> &arrvec) final
         {
-          this->mem->barrier();
+          this->mem->nghbr_barrier(this->rank);
           for (auto &bc : this->bcs[0]) bc->fill_halos_flux(arrvec, j, k);
           for (auto &bc : this->bcs[1]) bc->fill_halos_flux(arrvec, k, i);
           for (auto &bc : this->bcs[2]) bc->fill_halos_flux(arrvec, i, j);
         }
+
+        // fluxes of several equations exchanged within a single set of barriers
+        void xchng_flux(const std::vector<arrvec_t<typename parent_t::arr_t>*> &flxs)
+        {
+          this->mem->nghbr_barrier(this->rank);
+          for (auto &flx : flxs)
+          {
+            for (auto &bc : this->bcs[0]) bc->fill_halos_flux(*flx, j, k);
+            for (auto &bc : this->bcs[1]) bc->fill_halos_flux(*flx, k, i);
+            for (auto &bc : this->bcs[2]) bc->fill_halos_flux(*flx, i, j);
+          }
+        }
         
         virtual void xchng_sgs_div(
 	  typename parent_t::arr_t &arr,
 	  const idx_t<3> &range_ijk
         ) final
         {
-          this->mem->barrier();
+          this->mem->nghbr_barrier(this->rank);
           for (auto &bc : this->bcs[0]) bc->fill_halos_sgs_div(arr, range_ijk[1], range_ijk[2]^h);
           for (auto &bc : this->bcs[1]) bc->fill_halos_sgs_div(arr, range_ijk[2]^h, range_ijk[0]);
           for (auto &bc : this->bcs[2]) bc->fill_halos_sgs_div(arr, range_ijk[0], range_ijk[1]);
-          this->mem->barrier();
+          this->mem->nghbr_barrier(this->rank);
         }
 	
         virtual void xchng_sgs_vctr(arrvec_t<typename parent_t::arr_t> &av,
@@ -98,11 +182,11 @@ namespace libmpdataxx
 	                            const idx_t<3> &range_ijk
         ) final
 	{
-          this->mem->barrier();
+          this->mem->nghbr_barrier(this->rank);
           for (auto &bc : this->bcs[0]) bc->fill_halos_sgs_vctr(av, b, range_ijk[1], range_ijk[2]);
 	  for (auto &bc : this->bcs[1]) bc->fill_halos_sgs_vctr(av, b, range_ijk[2], range_ijk[0]);
 	  for (auto &bc : this->bcs[2]) bc->fill_halos_sgs_vctr(av, b, range_ijk[0], range_ijk[1]);
-          this->mem->barrier();
+          this->mem->nghbr_barrier(this->rank);
 	}
         
         virtual void xchng_sgs_tnsr_diag(arrvec_t<typename parent_t::arr_t> &av,
@@ -111,11 +195,11 @@ namespace libmpdataxx
 	                                 const idx_t<3> &range_ijk
         ) final
 	{
-          this->mem->barrier();
+          this->mem->nghbr_barrier(this->rank);
           for (auto &bc : this->bcs[0]) bc->fill_halos_sgs_tnsr(av, w, vip_div, range_ijk[1], range_ijk[2], this->dijk[0]);
 	  for (auto &bc : this->bcs[1]) bc->fill_halos_sgs_tnsr(av, w, vip_div, range_ijk[2], range_ijk[0], this->dijk[1]);
 	  for (auto &bc : this->bcs[2]) bc->fill_halos_sgs_tnsr(av, w, vip_div, range_ijk[0], range_ijk[1], this->dijk[2]);
-          this->mem->barrier();
+          this->mem->nghbr_barrier(this->rank);
 	}
         
         virtual void xchng_sgs_tnsr_offdiag(arrvec_t<typename parent_t::arr_t> &av,
@@ -125,7 +209,7 @@ namespace libmpdataxx
         ) final
 	{
           // off-diagonal components of stress tensor are treated the same as a vector
-          this->mem->barrier();
+          this->mem->nghbr_barrier(this->rank);
           for (auto &bc : this->bcs[0])
           {
             bc->fill_halos_sgs_vctr(av, bv[0], range_ijkm[1], range_ijk[2]^1, 3);
@@ -143,7 +227,7 @@ namespace libmpdataxx
             bc->fill_halos_sgs_vctr(av, bv[0], range_ijkm[0], range_ijk[1]^1, 2);
             bc->fill_halos_sgs_vctr(av, bv[1], range_ijk[0]^1, range_ijkm[1], 3);
           }
-          this->mem->barrier();
+          this->mem->nghbr_barrier(this->rank);
 	}
 
         virtual void xchng_vctr_nrml(
@@ -153,42 +237,51 @@ namespace libmpdataxx
           const bool cyclic = false
         ) final
         {
-          this->mem->barrier();
-          const auto range_ijk_0__ext_h = this->extend_range(range_ijk[0], ext, h);
-          const auto range_ijk_0__ext_1 = this->extend_range(range_ijk[0], ext, 1);
+          this->mem->nghbr_barrier(this->rank);
+          const auto range_ijk_0__ext_h = this->extend_range(0, range_ijk[0], ext, h);
+          const auto range_ijk_0__ext_1 = this->extend_range(0, range_ijk[0], ext, 1);
+          const auto range_ijk_1__ext_h = this->extend_range(1, range_ijk[1], ext, h);
+          const auto range_ijk_1__ext_1 = this->extend_range(1, range_ijk[1], ext, 1);
+          const auto range_ijk_2__ext_h = this->extend_range(2, range_ijk[2], ext, h);
+          const auto range_ijk_2__ext_1 = this->extend_range(2, range_ijk[2], ext, 1);
           if (!cyclic)
           {
-            for (auto &bc : this->bcs[1]) bc->fill_halos_vctr_nrml(arrvec[0], range_ijk[2]^ext^1, range_ijk[0]^ext^h);
+            for (auto &bc : this->bcs[1]) bc->fill_halos_vctr_nrml(arrvec[0], range_ijk_2__ext_1, range_ijk[0]^ext^h);
+            for (auto &bc : this->bcs[0]) bc->fill_halos_vctr_nrml(arrvec[1], range_ijk_1__ext_h, range_ijk_2__ext_1);
+            for (auto &bc : this->bcs[0]) bc->fill_halos_vctr_nrml(arrvec[2], range_ijk_1__ext_1, range_ijk_2__ext_h);
   
             // without this barrier, there is a race condition when some threads handle subdomains
             // with one gridpoint width, the problem manifests itself, for example, in pbl test
             // TODO: figure out the exact cause and try to avoid this barrier, what about 2D,
             //       what about atypical boundary condition choices -- rigid/cyclic/rigid etc
+            // (with decomposition in more than one dimension it is needed anyhow, as the
+            //  edges filled above are read below by other threads)
             if (parent_t::div3_mpdata)
             {
-              this->mem->barrier();
+              this->mem->nghbr_barrier(this->rank);
+            }
+            else
+            {
+              this->xchng_dim_barrier();
             }
 
-            for (auto &bc : this->bcs[2]) bc->fill_halos_vctr_nrml(arrvec[0], range_ijk_0__ext_h, range_ijk[1]^ext^1);
-
-            for (auto &bc : this->bcs[0]) bc->fill_halos_vctr_nrml(arrvec[1], range_ijk[1]^ext^h, range_ijk[2]^ext^1);
-            for (auto &bc : this->bcs[2]) bc->fill_halos_vctr_nrml(arrvec[1], range_ijk_0__ext_1, range_ijk[1]^ext^h);
-       
-            for (auto &bc : this->bcs[0]) bc->fill_halos_vctr_nrml(arrvec[2], range_ijk[1]^ext^1, range_ijk[2]^ext^h);
-            for (auto &bc : this->bcs[1]) bc->fill_halos_vctr_nrml(arrvec[2], range_ijk[2]^ext^h, range_ijk_0__ext_1);
+            for (auto &bc : this->bcs[2]) bc->fill_halos_vctr_nrml(arrvec[0], range_ijk_0__ext_h, range_ijk_1__ext_1);
+            for (auto &bc : this->bcs[2]) bc->fill_halos_vctr_nrml(arrvec[1], range_ijk_0__ext_1, range_ijk_1__ext_h);
+            for (auto &bc : this->bcs[1]) bc->fill_halos_vctr_nrml(arrvec[2], range_ijk_2__ext_h, range_ijk_0__ext_1);
           }
           else
           {
-            for (auto &bc : this->bcs[1]) bc->fill_halos_vctr_nrml_cyclic(arrvec[0], range_ijk[2]^ext^1, range_ijk_0__ext_h);
-            for (auto &bc : this->bcs[2]) bc->fill_halos_vctr_nrml_cyclic(arrvec[0], range_ijk_0__ext_h, range_ijk[1]^ext^1);
-
-            for (auto &bc : this->bcs[0]) bc->fill_halos_vctr_nrml_cyclic(arrvec[1], range_ijk[1]^ext^h, range_ijk[2]^ext^1);
-            for (auto &bc : this->bcs[2]) bc->fill_halos_vctr_nrml_cyclic(arrvec[1], range_ijk_0__ext_1, range_ijk[1]^ext^h);
-       
-            for (auto &bc : this->bcs[0]) bc->fill_halos_vctr_nrml_cyclic(arrvec[2], range_ijk[1]^ext^1, range_ijk[2]^ext^h);
-            for (auto &bc : this->bcs[1]) bc->fill_halos_vctr_nrml_cyclic(arrvec[2], range_ijk[2]^ext^h, range_ijk_0__ext_1);
+            for (auto &bc : this->bcs[1]) bc->fill_halos_vctr_nrml_cyclic(arrvec[0], range_ijk_2__ext_1, range_ijk_0__ext_h);
+            for (auto &bc : this->bcs[0]) bc->fill_halos_vctr_nrml_cyclic(arrvec[1], range_ijk_1__ext_h, range_ijk_2__ext_1);
+            for (auto &bc : this->bcs[0]) bc->fill_halos_vctr_nrml_cyclic(arrvec[2], range_ijk_1__ext_1, range_ijk_2__ext_h);
+
+            this->xchng_dim_barrier();
+
+            for (auto &bc : this->bcs[2]) bc->fill_halos_vctr_nrml_cyclic(arrvec[0], range_ijk_0__ext_h, range_ijk_1__ext_1);
+            for (auto &bc : this->bcs[2]) bc->fill_halos_vctr_nrml_cyclic(arrvec[1], range_ijk_0__ext_1, range_ijk_1__ext_h);
+            for (auto &bc : this->bcs[1]) bc->fill_halos_vctr_nrml_cyclic(arrvec[2], range_ijk_2__ext_h, range_ijk_0__ext_1);
           }
-          this->mem->barrier();
+          this->mem->nghbr_barrier(this->rank);
         }
 
         virtual void xchng_pres(
@@ -197,12 +290,17 @@ namespace libmpdataxx
           const int ext = 0
         ) final
         {
-          const auto range_ijk_0__ext = this->extend_range(range_ijk[0], ext);
-          this->mem->barrier();
-          for (auto &bc : this->bcs[0]) bc->fill_halos_pres(arr, range_ijk[1]^ext, range_ijk[2]^ext);
-          for (auto &bc : this->bcs[1]) bc->fill_halos_pres(arr, range_ijk[2]^ext, range_ijk_0__ext);
-          for (auto &bc : this->bcs[2]) bc->fill_halos_pres(arr, range_ijk_0__ext, range_ijk[1]^ext);
-          this->mem->barrier();
+          const auto range_ijk_0__ext = this->extend_range(0, range_ijk[0], ext);
+          const auto range_ijk_1__ext = this->extend_range(1, range_ijk[1], ext);
+          const auto range_ijk_2__ext = this->extend_range(2, range_ijk[2], ext);
+          this->xchng_sclr_stats(arr);
+          this->mem->nghbr_barrier(this->rank);
+          for (auto &bc : this->bcs[0]) bc->fill_halos_pres(arr, range_ijk_1__ext, range_ijk_2__ext);
+          this->xchng_dim_barrier();
+          for (auto &bc : this->bcs[1]) bc->fill_halos_pres(arr, range_ijk_2__ext, range_ijk_0__ext);
+          this->xchng_dim_barrier();
+          for (auto &bc : this->bcs[2]) bc->fill_halos_pres(arr, range_ijk_0__ext, range_ijk_1__ext);
+          this->mem->nghbr_barrier(this->rank);
         }
 
         virtual void set_edges(
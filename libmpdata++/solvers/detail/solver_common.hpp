@@ -9,6 +9,7 @@
 #include <libmpdata++/blitz.hpp>
 #include <libmpdata++/formulae/arakawa_c.hpp>
 #include <libmpdata++/concurr/detail/sharedmem.hpp>
+#include <libmpdata++/concurr/detail/placement.hpp>
 
 #include <libmpdata++/solvers/detail/monitor.hpp>
 
@@ -66,12 +67,15 @@ namespace libmpdataxx
         std::array<real_t, div3_mpdata ? 2 : 1> dt_stash;
         std::array<real_t, n_dims> dijk;
 
-	const idx_t<n_dims> ijk;
+	idx_t<n_dims> ijk; // not const as moved by rebalance()
 
         long long int timestep = 0;
         real_t time = 0;
         std::vector<int> n; 
 
+        // non-delayed and delayed equations (advected in two groups if ct_params_t::fused_eqns is set)
+        std::array<std::vector<int>, 2> eqns_fused;
+
         typedef concurr::detail::sharedmem<real_t, n_dims, n_tlev> mem_t; 
 	mem_t *mem;
 
@@ -90,19 +94,103 @@ namespace libmpdataxx
 
 	virtual void cycle(int e) final
 	{ 
+          for (int t = 0; t < n_tlev; ++t) mem->halo_invalidate(rank, mem->psi[e][t]);
 	  n[e] = (n[e] + 1) % n_tlev - n_tlev;  // -n_tlev so that n+1 does not give out of bounds
           if(is_last_eqn(e)) mem->cycle(rank); 
 	}
 
 	virtual void xchng(int e) = 0;
-        // TODO: implement flagging of valid/invalid halo for optimisations
+
+        // advection of a group of equations sharing the advector (see ct_params_t::fused_eqns),
+        // by default one after another
+        virtual void advop_fused(const std::vector<int> &eqns)
+        {
+          for (const int &e : eqns)
+          {
+            xchng(e);
+            advop(e);
+          }
+        }
+
+        // number of barriers involved in a single exchange of a scalar field
+        int xchng_sclr_barriers() const
+        {
+          return 2 + (n_dims - 1) * (mem->size != mem->decomp[0] ? 1 : 0);
+        }
+
+        // bookkeeping done at each exchange of a scalar field (halos get overwritten)
+        void xchng_sclr_stats(const arr_t &arr)
+        {
+          mem->halo_invalidate(rank, arr);
+          mem->xchng_stats[rank].done++;
+        }
+
+        // true (and accounted for as a skipped exchange) if halos of arr are known 
+        // to be filled to a given depth since its last modification (only with rt_params_t::halo_track);
+        // note: only the psi fields are tracked, and only modifications done 
+        //       through state() or by advection (see cycle()) are detected
+        bool halo_valid(const arr_t &arr, const int &depth)
+        {
+          if (!mem->halo_is_valid(rank, arr, depth)) return false;
+          mem->xchng_stats[rank].skipped++;
+          mem->xchng_stats[rank].barriers_saved += xchng_sclr_barriers();
+          return true;
+        }
 
         virtual void xchng_vctr_alng(arrvec_t<arr_t>&, const bool ad = false, const bool cyclic = false) = 0;
 
+        // moves the subdomain to a new range (see rebalance()), to be extended 
+        // by solvers that keep other ranges derived from it
+        virtual void set_subdomain(const idx_t<n_dims> &ijk_new)
+        {
+          ijk = ijk_new;
+        }
+
+        // called at the beginning of each solve(), to be extended by solvers that keep
+        // data derived from fields that might be modified from outside (e.g. G) between
+        // the calls; modifications of such fields within solve() (e.g. in the hooks)
+        // have to be followed by a call to it
+        virtual void cache_invalidate() {}
+
+        // dynamic load balancing: the slab boundaries along the first dimension
+        // are moved to equalise the cost measured since the last rebalancing
+        // (the halos are not tracked across the move, hence all marked as invalid)
+        void rebalance()
+        {
+          const rng_t i_new = mem->rebalance(rank, halo);
+          mem->halo_invalidate(rank);
+          if (i_new.first() == ijk.lbound(0) && i_new.last() == ijk.ubound(0)) return;
+          auto ijk_new = ijk;
+          ijk_new.lbound(0) = i_new.first();
+          ijk_new.ubound(0) = i_new.last();
+          set_subdomain(ijk_new);
+        }
+
+        // halos are filled in the order of bcs[d], with MPI processes exchanging halos 
+        // along the first dimension the order is reversed on every second process 
+        // so that the blocking exchanges pair up also in periodic domains
+        bool bcs_swapped(const int &d) const
+        {
+          return d == 0 && mem->distmem.rank() % 2 == 1;
+        }
+
+        // true if the zero-flux condition is applied at the left (or right) subdomain edge along dimension d
+        bool mirror_flux(const int &d, const bool rght) const
+        {
+          return bcs[d][bcs_swapped(d) != rght ? 1 : 0]->mirror_flux();
+        }
+
+        // true if the zero-flux condition is applied to the pressure gradient at the left (or right) 
+        // subdomain edge along dimension d
+        bool mirror_pres(const int &d, const bool rght) const
+        {
+          return bcs[d][bcs_swapped(d) != rght ? 1 : 0]->mirror_pres();
+        }
+
         void set_bcs(const int &d, bcp_t &bcl, bcp_t &bcr)
         {
-          bcs[d][0] = std::move(bcl);
-          bcs[d][1] = std::move(bcr);
+          bcs[d][bcs_swapped(d) ? 1 : 0] = std::move(bcl);
+          bcs[d][bcs_swapped(d) ? 0 : 1] = std::move(bcr);
         }
 
 	virtual real_t courant_number(const arrvec_t<arr_t>&) = 0;
@@ -121,27 +209,52 @@ namespace libmpdataxx
           scale(e, ct_params_t::hint_scale(e));
 	  xchng(e);
           advop(e);
-          if(!is_last_eqn(e))
+          // with separate temporaries for each equation (see ct_params_t::eqn_pipeline)
+          // threads proceed to the next equation without waiting for the others
+          if(!is_last_eqn(e) && !ct_params_t::eqn_pipeline)
             mem->barrier();
 	  cycle(e);  // note: assuming ascending order, mem->cycle is done after the lest eqn
           scale(e, -ct_params_t::hint_scale(e));
         }
 
-        // thread-aware range extension
+        // counterpart of solve_loop_body() for a group of equations advected together
+        void solve_fused_body(const std::vector<int> &eqns)
+        {
+          if (eqns.empty()) return;
+          for (const int &e : eqns) scale(e, ct_params_t::hint_scale(e));
+          advop_fused(eqns);
+          for (const int &e : eqns) cycle(e);
+          for (const int &e : eqns) scale(e, -ct_params_t::hint_scale(e));
+        }
+
+        // true if the subdomain touches the left/right edge of the domain in a given dimension
+        bool left_edge(const int &d) const { return ijk.lbound(d) == mem->grid_size[d].first(); }
+        bool rght_edge(const int &d) const { return ijk.ubound(d) == mem->grid_size[d].last(); }
+
+        // thread-aware range extension (extending only at domain edges, 
+        // elsewhere the extension belongs to the neighbouring subdomain)
         template <class n_t>
-        rng_t extend_range(const rng_t &r, const n_t n) const
+        rng_t extend_range(const int &d, const rng_t &r, const n_t n) const
         {
-          if (mem->size == 1) return r^n;
-          return rank == 0 ? rng_t((r - n).first(), r.last()) :
-                               rank == mem->size - 1 ? rng_t(r.first(), (r + n).last()) :
-                                 r;
+          return rng_t(
+            left_edge(d) ? (r - n).first() : r.first(),
+            rght_edge(d) ? (r + n).last()  : r.last()
+          );
         }
         
         // thread-aware range extension, variadic version
         template <class n_t, class... ns_t>
-        rng_t extend_range(const rng_t &r, const n_t n, const ns_t... ns) const
+        rng_t extend_range(const int &d, const rng_t &r, const n_t n, const ns_t... ns) const
         {
-          return extend_range(extend_range(r, n), ns...);
+          return extend_range(d, extend_range(d, r, n), ns...);
+        }
+
+        // with domain decomposition in more than one dimension, halo corners filled
+        // by bconds of one dimension are read by other threads when filling halos 
+        // in the next dimension
+        void xchng_dim_barrier()
+        {
+          if (mem->size != mem->decomp[0]) mem->nghbr_barrier(rank);
         }
 
         private:
@@ -209,6 +322,15 @@ namespace libmpdataxx
         struct rt_params_t 
         {
           std::array<int, n_dims> grid_size;
+          std::array<int, n_dims> decomp = {}; // number of subdomains in each dimension (all zeros: automatic choice)
+          bool nghbr_sync = false; // if true, halo exchanges synchronise only with the neighbouring subdomains
+          bool halo_track = false; // if true, exchanges of advectees with halos still valid are skipped (all modifications
+                                   // of the advectees done outside of the solver have to go through state() on every subdomain)
+          bool verbose = false; // if true, statistics of halo exchanges (and of rebalancing, thread pinning) are printed to stderr
+          concurr::numa_plc_t numa_plc = concurr::default_plc; // placement of memory pages on NUMA nodes
+          concurr::pin_plc_t pin_plc = concurr::no_pinning; // pinning of threads to CPUs
+          bool hybrid = false; // one subdomain per CPU package split among its threads (implies package pinning and first touch unless set otherwise)
+          int rebalance_every = 0; // if positive, slab boundaries along the first dimension are moved every so many time steps to equalise the per-thread cost
           real_t dt=0, max_abs_div_eps = blitz::epsilon(real_t(44)), max_courant = real_t(0.5);
         };
 
@@ -238,6 +360,9 @@ namespace libmpdataxx
           for (int d = 0; d < n_dims; ++d)
             if (p.grid_size[d] < 1) 
               throw std::runtime_error("bogus grid size");
+
+          for (int e = 0; e < n_eqns; ++e) 
+            eqns_fused[opts::isset(ct_params_t::delayed_step, opts::bit(e)) ? 1 : 0].push_back(e);
         }
 
         // dtor
@@ -251,12 +376,33 @@ namespace libmpdataxx
 #endif
         }
 
+        // allocation of the memory that depends on which domain edges are cyclic, called by concurr after alloc()
+        // (cyclic[d][0] and cyclic[d][1] for the left and right edges; edges between MPI processes are not cyclic)
+        static void alloc_bcond(
+          mem_t *,
+          const rt_params_t &,
+          const std::array<std::array<bool, 2>, n_dims> &
+        ) {}
+
+        // to be called from the thread that is going to run solve() (see concurr::first_touch)
+        void touch_subdomain()
+        {
+          mem->touch_subdomain(ijk);
+        }
+
 	virtual void solve(advance_arg_t nt) final
 	{   
           // multiple calls to sovlve() are meant to advance the solution by nt
           // TODO: does it really work with var_dt ? we do not advance by time exactly ...
           nt += ct_params_t::var_dt ? time : timestep;
 
+          // advectees might have been modified from outside since the last call
+          mem->halo_invalidate(rank);
+          cache_invalidate();
+
+          // only the time spent within solve() counts as the subdomain's cost
+          if (mem->rebalance_every > 0) mem->work_begin(rank);
+
           // being generous about out-of-loop barriers 
           if (timestep == 0)
           {
@@ -314,15 +460,23 @@ namespace libmpdataxx
             
             hook_ante_step();
 
-	    for (int e = 0; e < n_eqns; ++e)
+            if (ct_params_t::fused_eqns) solve_fused_body(eqns_fused[0]);
+            else for (int e = 0; e < n_eqns; ++e)
             {
               if (opts::isset(ct_params_t::delayed_step, opts::bit(e))) continue;
               solve_loop_body(e);
             }
 
+            // the delayed-step hook may need all non-delayed equations advected
+            if (
+              (ct_params_t::eqn_pipeline || ct_params_t::fused_eqns) && 
+              opts::most_significant(ct_params_t::delayed_step)
+            ) mem->barrier();
+
             hook_ante_delayed_step();
 
-	    for (int e = 0; e < n_eqns; ++e)
+            if (ct_params_t::fused_eqns) solve_fused_body(eqns_fused[1]);
+            else for (int e = 0; e < n_eqns; ++e)
             {
               if (!opts::isset(ct_params_t::delayed_step, opts::bit(e))) continue;
               solve_loop_body(e);
@@ -334,9 +488,12 @@ namespace libmpdataxx
             dt_stash[0] = dt;
             hook_post_step();
 
+            if (mem->rebalance_every > 0 && timestep % mem->rebalance_every == 0) rebalance();
+
             if (time >= nt) additional_steps--;
 	  }   
 
+          if (mem->rebalance_every > 0) mem->work_end(rank);
           mem->barrier();
           // note: hook_post_loop was removed as conficling with multiple-advance()-call logic
         }
@@ -348,6 +505,8 @@ namespace libmpdataxx
         // psi^{n+1} than psi^{n} (hence not using the name psi_n)
 	virtual arr_t &state(const int &e) final
 	{
+          // assuming the field is going to be modified
+          mem->halo_invalidate(rank, mem->psi[e][n[e]]);
 	  return mem->psi[e][n[e]];
 	}
 
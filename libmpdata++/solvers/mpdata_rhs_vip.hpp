@@ -34,7 +34,13 @@ namespace libmpdataxx
       using parent_t = detail::mpdata_rhs_vip_common<ct_params_t, minhalo>;
 
       // member fields
-      const rng_t im;
+      rng_t im;
+
+      void set_subdomain(const idx_t<1> &ijk_new)
+      {
+        parent_t::set_subdomain(ijk_new);
+        im = rng_t(this->i.first() - 1, this->i.last());
+      }
 
       void interpolate_in_space(arrvec_t<typename parent_t::arr_t> &dst,
                                 const arrvec_t<typename parent_t::arr_t> &src) final
@@ -93,7 +99,14 @@ namespace libmpdataxx
       using parent_t = detail::mpdata_rhs_vip_common<ct_params_t, minhalo>;
 
       // member fields
-      const rng_t im, jm;
+      rng_t im, jm;
+
+      void set_subdomain(const idx_t<2> &ijk_new)
+      {
+        parent_t::set_subdomain(ijk_new);
+        im = rng_t(this->i.first() - 1, this->i.last());
+        jm = rng_t(this->j.first() - 1, this->j.last());
+      }
 
       template<int d, class arr_t> 
       void intrp(
@@ -203,7 +216,15 @@ namespace libmpdataxx
       using parent_t = detail::mpdata_rhs_vip_common<ct_params_t, minhalo>;
 
       // member fields
-      const rng_t im, jm, km;
+      rng_t im, jm, km;
+
+      void set_subdomain(const idx_t<3> &ijk_new)
+      {
+        parent_t::set_subdomain(ijk_new);
+        im = rng_t(this->i.first() - 1, this->i.last());
+        jm = rng_t(this->j.first() - 1, this->j.last());
+        km = rng_t(this->k.first() - 1, this->k.last());
+      }
 
       template<int d, class arr_t> 
       void intrp(
@@ -7,8 +7,13 @@
 #pragma once
 
 #include <libmpdata++/solvers/detail/mpdata_rhs_vip_prs_gcrk.hpp> 
+#include <libmpdata++/solvers/detail/mpdata_rhs_vip_prs_mg.hpp> 
 #include <libmpdata++/solvers/detail/mpdata_rhs_vip_prs_mr.hpp> 
 #include <libmpdata++/solvers/detail/mpdata_rhs_vip_prs_pc.hpp> 
+#include <libmpdata++/solvers/detail/mpdata_rhs_vip_prs_plcr.hpp> 
+#if defined(USE_FFTW) && !defined(USE_MPI)
+#  include <libmpdata++/solvers/detail/mpdata_rhs_vip_prs_fft.hpp> 
+#endif
 
 namespace libmpdataxx
 {
@@ -19,14 +24,20 @@ namespace libmpdataxx
       mr, // minimal residual
       cr, // conjugate residual
       gcrk, // generalized conjugate residual (restarted after k steps)
-      pc  // preconditioned
+      pc, // preconditioned
+      mg, // geometric multigrid (preconditioned generalized conjugate residual or multigrid alone)
+      fft, // direct solver for constant G (preconditioned generalized conjugate residual, requires FFTW, not available with MPI)
+      plcr // pipelined conjugate residual (a single reduction per iteration)
     };
 
     const std::map<prs_scheme_t, std::string> prs2string = {
       {mr, "mr"},
       {cr, "cr"},
       {gcrk, "gcrk"},
-      {pc, "pc"}
+      {pc, "pc"},
+      {mg, "mg"},
+      {fft, "fft"},
+      {plcr, "plcr"}
     };
 
     struct mpdata_rhs_vip_prs_family_tag {};
@@ -93,5 +104,60 @@ namespace libmpdataxx
       protected:
       using solver_family = mpdata_rhs_vip_prs_family_tag;
     };
+
+    // geometric multigrid
+    template<typename ct_params_t, int minhalo>
+    class mpdata_rhs_vip_prs<
+      ct_params_t, minhalo,
+      typename std::enable_if<(int)ct_params_t::prs_scheme == (int)mg>::type
+    > : public detail::mpdata_rhs_vip_prs_mg<ct_params_t, ct_params_t::prs_k_iters, minhalo>
+    {
+      using parent_t = detail::mpdata_rhs_vip_prs_mg<ct_params_t, ct_params_t::prs_k_iters, minhalo>; 
+      using parent_t::parent_t; // inheriting constructors
+      
+      protected:
+      using solver_family = mpdata_rhs_vip_prs_family_tag;
+    };
+
+    // pipelined conjugate residual
+    template<typename ct_params_t, int minhalo>
+    class mpdata_rhs_vip_prs<
+      ct_params_t, minhalo,
+      typename std::enable_if<(int)ct_params_t::prs_scheme == (int)plcr>::type
+    > : public detail::mpdata_rhs_vip_prs_plcr<ct_params_t, minhalo>
+    {
+      using parent_t = detail::mpdata_rhs_vip_prs_plcr<ct_params_t, minhalo>; 
+      using parent_t::parent_t; // inheriting constructors
+      
+      protected:
+      using solver_family = mpdata_rhs_vip_prs_family_tag;
+    };
+
+#if defined(USE_FFTW) && !defined(USE_MPI)
+    // FFT-based direct solver
+    template<typename ct_params_t, int minhalo>
+    class mpdata_rhs_vip_prs<
+      ct_params_t, minhalo,
+      typename std::enable_if<(int)ct_params_t::prs_scheme == (int)fft>::type
+    > : public detail::mpdata_rhs_vip_prs_fft<ct_params_t, ct_params_t::prs_k_iters, minhalo>
+    {
+      using parent_t = detail::mpdata_rhs_vip_prs_fft<ct_params_t, ct_params_t::prs_k_iters, minhalo>; 
+      using parent_t::parent_t; // inheriting constructors
+      
+      protected:
+      using solver_family = mpdata_rhs_vip_prs_family_tag;
+    };
+#else
+    // the FFT-based direct solver compiled out
+    template<typename ct_params_t, int minhalo>
+    class mpdata_rhs_vip_prs<
+      ct_params_t, minhalo,
+      typename std::enable_if<(int)ct_params_t::prs_scheme == (int)fft>::type
+    >
+    {
+      static_assert((int)ct_params_t::prs_scheme != (int)fft,
+        "the fft pressure solver requires FFTW (-DUSE_FFTW) and does not support MPI (-DUSE_MPI)");
+    };
+#endif
   } // namespace solvers
 } // namescpae libmpdataxx
@@ -0,0 +1,82 @@
+/** 
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * @brief checks the blocking and spinning variants of concurr::detail::barrier
+ *        for correctness and reports their per-call cost (along with #pragma omp barrier) 
+ */
+
+#include <libmpdata++/concurr/detail/barrier.hpp>
+
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+
+#if defined(_OPENMP)
+#  include <omp.h>
+#endif
+
+const int n_iter = 20000;
+
+double bench(const int nthreads, const unsigned long spin)
+{
+  using namespace libmpdataxx::concurr::detail;
+
+  barrier b(nthreads, spin);
+  std::vector<int> phase(nthreads, 0);
+  std::vector<std::thread> threads;
+  std::atomic<bool> ok(true);
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (int rank = 0; rank < nthreads; ++rank)
+  {
+    threads.emplace_back([&, rank]() {
+      for (int it = 0; it < n_iter; ++it)
+      {
+        phase[rank] = it;
+        b.wait();
+        // every thread must have reached the same phase
+        for (int r = 0; r < nthreads; ++r) if (phase[r] != it) ok = false;
+        b.wait();
+      }
+    });
+  }
+  for (auto &th : threads) th.join();
+  auto t1 = std::chrono::steady_clock::now();
+
+  if (!ok) throw std::runtime_error("barrier let a thread through too early");
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / (2 * n_iter);
+}
+
+#if defined(_OPENMP)
+double bench_omp(const int nthreads)
+{
+  auto t0 = std::chrono::steady_clock::now();
+#pragma omp parallel num_threads(nthreads)
+  {
+    for (int it = 0; it < 2 * n_iter; ++it)
+    {
+#pragma omp barrier
+    }
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / (2 * n_iter);
+}
+#endif
+
+int main()
+{
+  const int nthreads = std::max(2u, std::min(8u, std::thread::hardware_concurrency()));
+
+  std::cout << "threads: " << nthreads << std::endl;
+  std::cout << "blocking barrier:  " << bench(nthreads, 0) << " ns/call" << std::endl;
+  std::cout << "spinning barrier:  " << bench(nthreads, 1 << 14) << " ns/call" << std::endl;
+#if defined(_OPENMP)
+  std::cout << "#pragma omp barrier: " << bench_omp(nthreads) << " ns/call" << std::endl;
+#endif
+}
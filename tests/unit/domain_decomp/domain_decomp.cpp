@@ -0,0 +1,83 @@
+/** 
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * @brief checks if slab, pencil and block domain decompositions give the same results as a serial run
+ *        (with global and with neighbour-only synchronisation of halo exchanges, 
+ *        and with the hybrid per-package decomposition)
+ */
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/concurr/serial.hpp>
+#include <libmpdata++/concurr/cxx11_thread.hpp>
+#include <libmpdata++/concurr/openmp.hpp>
+
+using namespace libmpdataxx;
+
+struct ct_params_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = 3 };
+  enum { n_eqns = 1 };
+};
+
+using solver_t = solvers::mpdata<ct_params_t>;
+
+template <template <class, bcond::bcond_e...> class concurr_t>
+double run(const std::array<int, 3> &decomp, const bool nghbr_sync = false, const bool hybrid = false)
+{
+  const int nt = 20;
+
+  typename solver_t::rt_params_t p;
+  p.grid_size = {9, 10, 11};
+  p.decomp = decomp;
+  p.nghbr_sync = nghbr_sync;
+  p.hybrid = hybrid;
+
+  concurr_t<solver_t, 
+    bcond::cyclic, bcond::cyclic, 
+    bcond::cyclic, bcond::cyclic, 
+    bcond::cyclic, bcond::cyclic
+  > run(p);
+
+  run.advectee() = 0;
+  run.advectee()(rng_t(2, 8), rng_t(3, 6), rng_t(1, 4)) = 1;
+  for (int d = 0; d < 3; ++d) run.advector(d) = .1 * (d + 1);
+
+  run.advance(nt);
+
+  // a position-weighted checksum
+  return blitz::sum(run.advectee() * (1 + blitz::tensor::i + 10 * blitz::tensor::j + 100 * blitz::tensor::k));
+}
+
+int main()
+{
+  const double expected = run<concurr::serial>({1, 1, 1});
+
+  for (const auto &decomp : std::vector<std::array<int, 3>>{{4, 1, 1}, {1, 2, 1}, {2, 2, 1}, {2, 2, 2}, {1, 4, 2}})
+  {
+    const double result = run<concurr::cxx11_thread>(decomp);
+    std::cerr << decomp[0] << "x" << decomp[1] << "x" << decomp[2] << ": " << result << " vs. " << expected << std::endl;
+    if (result != expected) throw std::runtime_error("result depends on domain decomposition");
+
+    if (run<concurr::cxx11_thread>(decomp, true) != expected) 
+      throw std::runtime_error("result depends on the synchronisation mode");
+  }
+
+  // one slab per package split along y, falling back to the default if the threads do not split evenly
+  using mem_t = concurr::detail::sharedmem<double, 3, 1>;
+  if (mem_t::hybrid_decomp({32, 16, 8}, 8, 2) != std::array<int, 3>{2, 4, 1})
+    throw std::runtime_error("unexpected hybrid decomposition");
+  if (mem_t::hybrid_decomp({32, 16, 8}, 8, 3) != mem_t::auto_decomp({32, 16, 8}, 8))
+    throw std::runtime_error("unexpected hybrid decomposition fallback");
+
+  if (run<concurr::cxx11_thread>({0, 0, 0}, false, true) != expected) 
+    throw std::runtime_error("result depends on domain decomposition (hybrid)");
+
+#if defined(_OPENMP)
+  if (run<concurr::openmp>({2, 2, 2}) != expected) 
+    throw std::runtime_error("result depends on domain decomposition (OpenMP)");
+#endif
+}
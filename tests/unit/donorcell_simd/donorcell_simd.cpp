@@ -0,0 +1,216 @@
+/** 
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * @brief checks if the loop-based donor-cell kernels (formulae::donorcell::calc_flux() and donorcell())
+ *        agree with the blitz expressions (make_flux() and donorcell_sum()) for row-major arrays
+ *        (vectorised loops) and column-major arrays (plain loops), and reports the timings of both
+ */
+
+#include <libmpdata++/formulae/donorcell_formulae.hpp>
+
+#include <chrono>
+#include <limits>
+#include <stdexcept>
+#include <iostream>
+
+using namespace libmpdataxx;
+
+// a deterministic value depending on the indices (and not on the storage order)
+template <class arr_t>
+void fill(arr_t &a, const int seed, const typename arr_t::T_numtype offset)
+{
+  for (auto it = a.begin(); it != a.end(); ++it)
+  {
+    unsigned long s = seed;
+    for (int d = 0; d < arr_t::rank_; ++d) s = (1103515245 * (s + it.position()[d] + 3) + 12345) % 2147483648ul;
+    *it = typename arr_t::T_numtype(s) / 2147483648. + offset;
+  }
+}
+
+template <class real_t, int n_dims>
+struct fields_t
+{
+  using arr_t = blitz::Array<real_t, n_dims>;
+  arr_t psi, psi_new, G;
+  arrvec_t<arr_t> GC, flx, khn_tmp;
+  idx_t<n_dims> ijk;
+
+  fields_t(const int nx, const blitz::GeneralArrayStorage<n_dims> &strg)
+  {
+    blitz::TinyVector<rng_t, n_dims> shape;
+    for (int d = 0; d < n_dims; ++d) shape[d] = rng_t(-1, nx);
+    ijk = idx_t<n_dims>(blitz::TinyVector<int, n_dims>(0), blitz::TinyVector<int, n_dims>(nx - 1));
+
+    for (auto a : {&psi, &psi_new, &G}) a->reference(arr_t(shape, strg));
+    for (int d = 0; d < n_dims; ++d) 
+    {
+      GC.push_back(new arr_t(shape, strg));
+      flx.push_back(new arr_t(shape, strg));
+    }
+    for (int c = 0; c < 3; ++c) khn_tmp.push_back(new arr_t(shape, strg));
+
+    fill(psi, 0, -.25);
+    fill(G, 1, 1);
+    for (int d = 0; d < n_dims; ++d) 
+    {
+      fill(GC[d], 2 + d, -.5);
+      flx[d] = 0;
+    }
+    psi_new = 0;
+  }
+};
+
+// blitz expressions
+template <opts::opts_t opts, class real_t>
+void blitz_path(fields_t<real_t, 1> &f)
+{
+  using namespace formulae::donorcell;
+  const rng_t i = f.ijk[0], im(i.first() - 1, i.last());
+  f.flx[0](im+h) = make_flux<opts>(f.psi, f.GC[0], im);
+  donorcell_sum<opts>(f.khn_tmp, f.ijk, f.psi_new(f.ijk), f.psi(f.ijk), 
+    f.flx[0](i+h), f.flx[0](i-h), 
+    formulae::G<opts>(f.G, i)
+  );
+}
+
+template <opts::opts_t opts, class real_t>
+void blitz_path(fields_t<real_t, 2> &f)
+{
+  using namespace formulae::donorcell;
+  const rng_t i = f.ijk[0], j = f.ijk[1], im(i.first() - 1, i.last()), jm(j.first() - 1, j.last());
+  f.flx[0](im+h, j) = make_flux<opts, 0>(f.psi, f.GC[0], im, j);
+  f.flx[1](i, jm+h) = make_flux<opts, 1>(f.psi, f.GC[1], jm, i);
+  donorcell_sum<opts>(f.khn_tmp, f.ijk, f.psi_new(f.ijk), f.psi(f.ijk), 
+    f.flx[0](i+h, j), f.flx[0](i-h, j), 
+    f.flx[1](i, j+h), f.flx[1](i, j-h), 
+    formulae::G<opts, 0>(f.G, i, j)
+  );
+}
+
+template <opts::opts_t opts, class real_t>
+void blitz_path(fields_t<real_t, 3> &f)
+{
+  using namespace formulae::donorcell;
+  const rng_t i = f.ijk[0], j = f.ijk[1], k = f.ijk[2], im(i.first() - 1, i.last()), jm(j.first() - 1, j.last()), km(k.first() - 1, k.last());
+  f.flx[0](im+h, j, k) = make_flux<opts, 0>(f.psi, f.GC[0], im, j, k);
+  f.flx[1](i, jm+h, k) = make_flux<opts, 1>(f.psi, f.GC[1], jm, k, i);
+  f.flx[2](i, j, km+h) = make_flux<opts, 2>(f.psi, f.GC[2], km, i, j);
+  donorcell_sum<opts>(f.khn_tmp, f.ijk, f.psi_new(f.ijk), f.psi(f.ijk), 
+    f.flx[0](i+h, j, k), f.flx[0](i-h, j, k), 
+    f.flx[1](i, j+h, k), f.flx[1](i, j-h, k), 
+    f.flx[2](i, j, k+h), f.flx[2](i, j, k-h), 
+    formulae::G<opts, 0>(f.G, i, j, k)
+  );
+}
+
+// loops
+template <opts::opts_t opts, class real_t>
+void loop_path(fields_t<real_t, 1> &f)
+{
+  using namespace formulae::donorcell;
+  const rng_t i = f.ijk[0], im(i.first() - 1, i.last());
+  calc_flux<opts>(f.flx[0], f.psi, f.GC[0], im);
+  donorcell<opts>(f.psi_new, f.psi, f.flx, f.G, i);
+}
+
+template <opts::opts_t opts, class real_t>
+void loop_path(fields_t<real_t, 2> &f)
+{
+  using namespace formulae::donorcell;
+  const rng_t i = f.ijk[0], j = f.ijk[1], im(i.first() - 1, i.last()), jm(j.first() - 1, j.last());
+  calc_flux<opts, 0>(f.flx[0], f.psi, f.GC[0], im, j);
+  calc_flux<opts, 1>(f.flx[1], f.psi, f.GC[1], jm, i);
+  donorcell<opts>(f.psi_new, f.psi, f.flx, f.G, i, j);
+}
+
+template <opts::opts_t opts, class real_t>
+void loop_path(fields_t<real_t, 3> &f)
+{
+  using namespace formulae::donorcell;
+  const rng_t i = f.ijk[0], j = f.ijk[1], k = f.ijk[2], im(i.first() - 1, i.last()), jm(j.first() - 1, j.last()), km(k.first() - 1, k.last());
+  calc_flux<opts, 0>(f.flx[0], f.psi, f.GC[0], im, j, k);
+  calc_flux<opts, 1>(f.flx[1], f.psi, f.GC[1], jm, k, i);
+  calc_flux<opts, 2>(f.flx[2], f.psi, f.GC[2], km, i, j);
+  donorcell<opts>(f.psi_new, f.psi, f.flx, f.G, i, j, k);
+}
+
+// max difference relative to the max magnitude in units of epsilon 
+// (the blitz expressions might get evaluated with fused multiply-adds)
+template <class arr_t>
+double ulps(const arr_t &a, const arr_t &b)
+{
+  using real_t = typename arr_t::T_numtype;
+  return max(abs(a - b)) / max(abs(a)) / std::numeric_limits<real_t>::epsilon();
+}
+
+template <opts::opts_t opts, class real_t, int n_dims>
+void test(const int nx)
+{
+  fields_t<real_t, n_dims> 
+    bltz(nx, blitz::GeneralArrayStorage<n_dims>()), 
+    cntg(nx, blitz::GeneralArrayStorage<n_dims>()), 
+    strd(nx, blitz::ColumnMajorArray<n_dims>());
+
+  blitz_path<opts>(bltz);
+  loop_path<opts>(cntg);
+  loop_path<opts>(strd);
+
+  // the same loops on both arrays
+  if (any(cntg.psi_new(cntg.ijk) != strd.psi_new(strd.ijk))) 
+    throw std::runtime_error("row-major vs. column-major");
+
+  // the same operations as in the blitz expressions
+  if (ulps(bltz.psi_new(bltz.ijk), cntg.psi_new(cntg.ijk)) > 4) 
+    throw std::runtime_error("loops vs. blitz expressions");
+}
+
+template <opts::opts_t opts, class real_t>
+void test_all()
+{
+  test<opts, real_t, 1>(1001);
+  test<opts, real_t, 2>(67);
+  test<opts, real_t, 3>(19);
+}
+
+template <opts::opts_t opts, class real_t, class path_t>
+double bench(fields_t<real_t, 3> &f, const path_t &path)
+{
+  const int n_rep = 20;
+  path(f);
+  auto t0 = std::chrono::steady_clock::now();
+  for (int r = 0; r < n_rep; ++r) path(f);
+  auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(t1 - t0).count() / n_rep;
+}
+
+template <opts::opts_t opts, class real_t>
+void bench_all(const char *name)
+{
+  fields_t<real_t, 3> f(96, blitz::GeneralArrayStorage<3>());
+  const double 
+    t_bltz = bench<opts>(f, [](fields_t<real_t, 3> &f){ blitz_path<opts>(f); }), 
+    t_loop = bench<opts>(f, [](fields_t<real_t, 3> &f){ loop_path<opts>(f); });
+  std::cerr << name << " (3D, 96^3, " << sizeof(real_t) * 8 << " bit):"
+    << " blitz expressions: " << t_bltz * 1e3 << " ms,"
+    << " loops: " << t_loop * 1e3 << " ms,"
+    << " speed-up: " << t_bltz / t_loop << std::endl;
+}
+
+int main()
+{
+  test_all<opts::opts_t(0), double>();
+  test_all<opts::abs,       double>();
+  test_all<opts::npa,       double>();
+  test_all<opts::nug,       double>();
+  test_all<opts::khn,       double>();
+  test_all<opts::nug | opts::khn, float>();
+  test_all<opts::abs | opts::npa, float>();
+
+  bench_all<opts::opts_t(0), double>("default");
+  bench_all<opts::opts_t(0), float >("default");
+  bench_all<opts::nug,       double>("nug    ");
+  bench_all<opts::khn,       double>("khn    ");
+}
@@ -0,0 +1,96 @@
+/** 
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * @brief checks if ensemble members advanced by a shared pool of workers
+ *        give the same results as standalone runs, and if the threaded members run 
+ *        on the ensemble's threads only (no threads of their own)
+ */
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/concurr/serial.hpp>
+#include <libmpdata++/concurr/cxx11_thread.hpp>
+#include <libmpdata++/concurr/ensemble.hpp>
+
+#if defined(__linux__)
+#  include <dirent.h>
+#endif
+
+using namespace libmpdataxx;
+
+struct ct_params_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = 2 };
+  enum { n_eqns = 1 };
+};
+
+using solver_t = solvers::mpdata<ct_params_t>;
+
+const int nx = 16, ny = 12, nt = 10, n_members = 7;
+
+template <class run_t>
+void init(run_t &run, const int m)
+{
+  // member-dependent initial condition
+  run.advectee() = 0;
+  run.advectee()(rng_t(2, 5 + m % 4), rng_t(3, 6)) = 1 + m;
+  run.advector(0) = .2;
+  run.advector(1) = -.1;
+}
+
+// number of threads of the process (-1 if unknown)
+int n_proc_threads()
+{
+  int n = -1;
+#if defined(__linux__)
+  if (DIR *dir = opendir("/proc/self/task"))
+  {
+    n = 0;
+    while (dirent *e = readdir(dir)) if (e->d_name[0] != '.') ++n;
+    closedir(dir);
+  }
+#endif
+  return n;
+}
+
+template <template <class, bcond::bcond_e...> class concurr_t>
+void test(const std::array<int, 2> &decomp, const int n_workers)
+{
+  using run_t = concurr_t<solver_t, bcond::cyclic, bcond::cyclic, bcond::cyclic, bcond::cyclic>;
+
+  typename solver_t::rt_params_t p;
+  p.grid_size = {nx, ny};
+  p.decomp = decomp;
+
+  const int n_before = n_proc_threads();
+  concurr::ensemble<run_t> ens(n_members, p, n_workers);
+  if (n_before > 0 && n_proc_threads() - n_before != ens.n_workers() * ens[0].n_threads())
+    throw std::runtime_error("ensemble members with threads of their own");
+  for (int m = 0; m < n_members; ++m) init(ens[m], m);
+  ens.advance(nt / 2);
+  ens.advance(nt / 2);
+
+  if (ens.stats().member_steps != n_members * nt) 
+    throw std::runtime_error("wrong number of member-steps");
+
+  for (int m = 0; m < n_members; ++m)
+  {
+    typename solver_t::rt_params_t ps;
+    ps.grid_size = p.grid_size;
+    concurr::serial<solver_t, bcond::cyclic, bcond::cyclic, bcond::cyclic, bcond::cyclic> ref(ps);
+    init(ref, m);
+    ref.advance(nt);
+    if (blitz::any(ref.advectee() != ens[m].advectee()))
+      throw std::runtime_error("ensemble member differs from a standalone run");
+  }
+}
+
+int main()
+{
+  test<concurr::serial>({1, 1}, 0); // one core per member, default number of workers
+  test<concurr::serial>({1, 1}, 3); // more members than workers
+  test<concurr::cxx11_thread>({2, 1}, 2); // two cores per member
+}
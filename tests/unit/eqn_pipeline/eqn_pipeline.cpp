@@ -0,0 +1,71 @@
+/** 
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * @brief checks if advecting multiple equations with ct_params_t::eqn_pipeline
+ *        (per-equation temporaries, no barriers between equations) gives 
+ *        the same results as the default setting
+ */
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/concurr/cxx11_thread.hpp>
+
+using namespace libmpdataxx;
+
+template <int opts_arg, bool pipeline>
+struct ct_params_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = 3 };
+  enum { n_eqns = 3 };
+  enum { opts = opts_arg };
+  enum { eqn_pipeline = pipeline };
+};
+
+const int nx = 16, ny = 12, nz = 10, nt = 10;
+
+template <int opts_arg, bool pipeline>
+blitz::Array<double, 3> run(const int e)
+{
+  using solver_t = solvers::mpdata<ct_params_t<opts_arg, pipeline>>;
+  typename solver_t::rt_params_t p;
+  p.grid_size = {nx, ny, nz};
+  p.decomp = {2, 2, 1};
+  p.n_iters = opts::isset(opts_arg, opts::iga) ? 2 : 3; // infinite gauge uses a single corrective iteration
+
+  concurr::cxx11_thread<
+    solver_t, 
+    bcond::cyclic, bcond::cyclic,
+    bcond::cyclic, bcond::cyclic,
+    bcond::cyclic, bcond::cyclic
+  > slv(p);
+
+  for (int ee = 0; ee < ct_params_t<opts_arg, pipeline>::n_eqns; ++ee)
+  {
+    slv.advectee(ee) = 1;
+    slv.advectee(ee)(rng_t(2, 6 + 2 * ee), rng_t(3, 7), rng_t(1, 4 + ee)) = 2 + ee;
+  }
+  slv.advector(0) = .2;
+  slv.advector(1) = -.3;
+  slv.advector(2) = .1;
+
+  slv.advance(nt);
+  return slv.advectee(e).copy();
+}
+
+template <int opts_arg>
+void test()
+{
+  for (int e = 0; e < 3; ++e)
+    if (blitz::any(run<opts_arg, false>(e) != run<opts_arg, true>(e)))
+      throw std::runtime_error("results differ with eqn_pipeline");
+}
+
+int main()
+{
+  test<0>();
+  test<opts::fct>();
+  test<opts::fct | opts::iga>();
+}
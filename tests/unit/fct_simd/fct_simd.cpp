@@ -0,0 +1,133 @@
+/** 
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * @brief checks if the FCT limiter formulae give bitwise identical results
+ *        when run on row-major arrays (vectorised loops over contiguous views)
+ *        and on column-major arrays (the same loops on blitz arrays)
+ */
+
+#include <libmpdata++/formulae/mpdata/formulae_mpdata_fct_2d.hpp>
+#include <libmpdata++/formulae/mpdata/formulae_mpdata_fct_3d.hpp>
+
+#include <stdexcept>
+#include <iostream>
+
+using namespace libmpdataxx;
+
+template <int n_dims>
+using arr_t = blitz::Array<double, n_dims>;
+
+// a deterministic fill with values of both signs (depending on the indices, not on the storage order)
+template <int n_dims>
+void fill(arr_t<n_dims> &a, const int seed)
+{
+  for (auto it = a.begin(); it != a.end(); ++it)
+  {
+    unsigned long s = seed;
+    for (int d = 0; d < n_dims; ++d) s = (1103515245 * (s + it.position()[d] + 3) + 12345) % 2147483648ul;
+    *it = double(s) / 2147483648. - .25;
+  }
+}
+
+// a set of arrays for the limiter with the given storage order
+template <int n_dims>
+struct fields_t
+{
+  arr_t<n_dims> psi, psi_min, psi_max, beta_up, beta_dn, G;
+  arrvec_t<arr_t<n_dims>> flx, GC_corr, GC_m;
+
+  fields_t(const blitz::TinyVector<blitz::Range, n_dims> &shape, const blitz::GeneralArrayStorage<n_dims> &strg)
+  {
+    for (auto a : {&psi, &psi_min, &psi_max, &beta_up, &beta_dn, &G}) 
+    {
+      a->reference(arr_t<n_dims>(shape, strg));
+      *a = 0;
+    }
+    for (auto av : {&flx, &GC_corr, &GC_m})
+    {
+      for (int d = 0; d < n_dims; ++d) 
+      {
+        av->push_back(new arr_t<n_dims>(shape, strg));
+        (*av)[d] = 0;
+      }
+    }
+    fill(psi, 0);
+    for (int d = 0; d < n_dims; ++d) 
+    {
+      fill(flx[d], 1 + d);
+      fill(GC_corr[d], 4 + d);
+    }
+    fill(G, 7);
+    G = 1 + G * G;
+  }
+};
+
+template <int n_dims>
+void check(const fields_t<n_dims> &a, const fields_t<n_dims> &b, const char *what)
+{
+  bool ok = all(a.psi_min == b.psi_min) && all(a.psi_max == b.psi_max)
+         && all(a.beta_up == b.beta_up) && all(a.beta_dn == b.beta_dn);
+  for (int d = 0; d < n_dims; ++d) ok = ok && all(a.GC_m[d] == b.GC_m[d]);
+  if (!ok) throw std::runtime_error(what);
+}
+
+template <opts::opts_t opts>
+void test_2d()
+{
+  const int n = 17;
+  const rng_t i(0, n-1), j(0, n-1), im(-1, n-1), jm(-1, n-1);
+  const blitz::TinyVector<blitz::Range, 2> shape(rng_t(-2, n+1), rng_t(-2, n+1));
+
+  fields_t<2> 
+    cntg(shape, blitz::GeneralArrayStorage<2>()), 
+    strd(shape, blitz::ColumnMajorArray<2>());
+  
+  for (auto f : {&cntg, &strd})
+  {
+    formulae::mpdata::psi_min_max(f->psi_min, f->psi_max, f->psi, i^1, j^1);
+    formulae::mpdata::beta_up<opts>(f->beta_up, f->psi, f->psi_max, f->flx, f->G, i^1, j^1);
+    formulae::mpdata::beta_dn<opts>(f->beta_dn, f->psi, f->psi_min, f->flx, f->G, i^1, j^1);
+    formulae::mpdata::GC_mono<opts, 0>(f->GC_m, f->psi, f->beta_up, f->beta_dn, f->GC_corr, f->G, im, j);
+    formulae::mpdata::GC_mono<opts, 1>(f->GC_m, f->psi, f->beta_up, f->beta_dn, f->GC_corr, f->G, jm, i);
+  }
+  check(cntg, strd, "2D");
+}
+
+template <opts::opts_t opts>
+void test_3d()
+{
+  const int n = 9;
+  const rng_t i(0, n-1), j(0, n-1), k(0, n-1), im(-1, n-1), jm(-1, n-1), km(-1, n-1);
+  const blitz::TinyVector<blitz::Range, 3> shape(rng_t(-2, n+1), rng_t(-2, n+1), rng_t(-2, n+1));
+
+  fields_t<3> 
+    cntg(shape, blitz::GeneralArrayStorage<3>()), 
+    strd(shape, blitz::ColumnMajorArray<3>());
+
+  for (auto f : {&cntg, &strd})
+  {
+    formulae::mpdata::psi_min_max(f->psi_min, f->psi_max, f->psi, i^1, j^1, k^1);
+    formulae::mpdata::beta_up<opts>(f->beta_up, f->psi, f->psi_max, f->flx, f->G, i^1, j^1, k^1);
+    formulae::mpdata::beta_dn<opts>(f->beta_dn, f->psi, f->psi_min, f->flx, f->G, i^1, j^1, k^1);
+    formulae::mpdata::GC_mono<opts, 0>(f->GC_m, f->psi, f->beta_up, f->beta_dn, f->GC_corr, f->G, im, j, k);
+    formulae::mpdata::GC_mono<opts, 1>(f->GC_m, f->psi, f->beta_up, f->beta_dn, f->GC_corr, f->G, jm, k, i);
+    formulae::mpdata::GC_mono<opts, 2>(f->GC_m, f->psi, f->beta_up, f->beta_dn, f->GC_corr, f->G, km, i, j);
+  }
+  check(cntg, strd, "3D");
+}
+
+int main()
+{
+  test_2d<opts::fct>();
+  test_2d<opts::fct | opts::abs>();
+  test_2d<opts::fct | opts::iga>();
+  test_2d<opts::fct | opts::nug>();
+
+  test_3d<opts::fct>();
+  test_3d<opts::fct | opts::abs>();
+  test_3d<opts::fct | opts::iga>();
+  test_3d<opts::fct | opts::nug>();
+}
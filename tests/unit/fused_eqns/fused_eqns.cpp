@@ -0,0 +1,111 @@
+/** 
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * @brief checks if advecting multiple equations with ct_params_t::fused_eqns
+ *        (all equations advected tile by tile) gives the same results 
+ *        as the default setting
+ */
+
+// small tiles so that the subdomains are split into several of them
+#define LIBMPDATAXX_TILE_BYTES 512
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/concurr/cxx11_thread.hpp>
+
+using namespace libmpdataxx;
+
+template <int n_dims_arg, int opts_arg, bool fused>
+struct ct_params_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = n_dims_arg };
+  enum { n_eqns = 3 };
+  enum { opts = opts_arg };
+  enum { fused_eqns = fused };
+};
+
+const int nx = 16, ny = 12, nz = 10, nt = 10;
+
+template <int opts_arg>
+int n_iters()
+{
+  return opts::isset(opts_arg, opts::iga) ? 2 : 3; // infinite gauge uses a single corrective iteration
+}
+
+template <int opts_arg, bool fused>
+blitz::Array<double, 2> run_2d(const int e)
+{
+  using solver_t = solvers::mpdata<ct_params_t<2, opts_arg, fused>>;
+  typename solver_t::rt_params_t p;
+  p.grid_size = {nx, ny};
+  p.n_iters = n_iters<opts_arg>();
+
+  concurr::cxx11_thread<
+    solver_t, 
+    bcond::cyclic, bcond::cyclic,
+    bcond::cyclic, bcond::cyclic
+  > slv(p);
+
+  for (int ee = 0; ee < 3; ++ee)
+  {
+    slv.advectee(ee) = 1;
+    slv.advectee(ee)(rng_t(2, 6 + 2 * ee), rng_t(3, 4 + ee)) = 2 + ee;
+  }
+  slv.advector(0) = .2;
+  slv.advector(1) = -.3;
+
+  slv.advance(nt);
+  return slv.advectee(e).copy();
+}
+
+template <int opts_arg, bool fused>
+blitz::Array<double, 3> run_3d(const int e)
+{
+  using solver_t = solvers::mpdata<ct_params_t<3, opts_arg, fused>>;
+  typename solver_t::rt_params_t p;
+  p.grid_size = {nx, ny, nz};
+  p.decomp = {2, 2, 1};
+  p.n_iters = n_iters<opts_arg>();
+
+  concurr::cxx11_thread<
+    solver_t, 
+    bcond::cyclic, bcond::cyclic,
+    bcond::cyclic, bcond::cyclic,
+    bcond::cyclic, bcond::cyclic
+  > slv(p);
+
+  for (int ee = 0; ee < 3; ++ee)
+  {
+    slv.advectee(ee) = 1;
+    slv.advectee(ee)(rng_t(2, 6 + 2 * ee), rng_t(3, 7), rng_t(1, 4 + ee)) = 2 + ee;
+  }
+  slv.advector(0) = .2;
+  slv.advector(1) = -.3;
+  slv.advector(2) = .1;
+
+  slv.advance(nt);
+  return slv.advectee(e).copy();
+}
+
+template <int opts_arg>
+void test()
+{
+  for (int e = 0; e < 3; ++e)
+  {
+    if (blitz::any(run_2d<opts_arg, false>(e) != run_2d<opts_arg, true>(e)))
+      throw std::runtime_error("results differ with fused_eqns in 2D");
+    if (blitz::any(run_3d<opts_arg, false>(e) != run_3d<opts_arg, true>(e)))
+      throw std::runtime_error("results differ with fused_eqns in 3D");
+  }
+}
+
+int main()
+{
+  test<0>();
+  test<opts::iga>();
+  test<opts::abs | opts::dfl>();
+  test<opts::fct>();
+}
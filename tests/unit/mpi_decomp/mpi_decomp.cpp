@@ -0,0 +1,91 @@
+/** 
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * @brief checks if runs on several MPI processes (with and without threads within each)
+ *        give the same results as a run on a single process 
+ *        (the reference is written to a file given as argument if there is one process)
+ */
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/concurr/serial.hpp>
+#include <libmpdata++/concurr/cxx11_thread.hpp>
+
+#include <boost/mpi/communicator.hpp>
+#include <boost/mpi/collectives.hpp>
+
+#include <fstream>
+#include <iomanip>
+
+using namespace libmpdataxx;
+
+struct ct_params_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = 3 };
+  enum { n_eqns = 1 };
+};
+
+using solver_t = solvers::mpdata<ct_params_t>;
+
+template <template <class, bcond::bcond_e...> class concurr_t>
+double run(const std::array<int, 3> &decomp, const bool nghbr_sync = false)
+{
+  const int nt = 20;
+
+  typename solver_t::rt_params_t p;
+  p.grid_size = {12, 10, 11};
+  p.decomp = decomp;
+  p.nghbr_sync = nghbr_sync;
+
+  concurr_t<solver_t, 
+    bcond::cyclic, bcond::cyclic, 
+    bcond::cyclic, bcond::cyclic, 
+    bcond::cyclic, bcond::cyclic
+  > run(p);
+
+  // advectee() is the part of the domain owned by the process, indexed globally
+  using namespace blitz::tensor;
+  run.advectee() = blitz::where(i >= 2 && i <= 8 && j >= 3 && j <= 6 && k >= 1 && k <= 4, 1, 0);
+  for (int d = 0; d < 3; ++d) run.advector(d) = .1 * (d + 1);
+
+  run.advance(nt);
+
+  // a position-weighted checksum
+  return boost::mpi::all_reduce(
+    boost::mpi::communicator(), 
+    double(blitz::sum(run.advectee() * (1 + i + 10 * j + 100 * k))), 
+    std::plus<double>()
+  );
+}
+
+int main(int argc, char **argv)
+{
+  if (argc != 2) throw std::runtime_error("expecting reference file name as argument");
+
+  const double result = run<concurr::serial>({1, 1, 1});
+
+  boost::mpi::communicator world;
+  if (world.size() == 1) 
+  {
+    std::ofstream(argv[1]) << std::setprecision(17) << result << std::endl;
+    return 0;
+  }
+
+  double expected;
+  std::ifstream(argv[1]) >> expected;
+
+  for (const auto &res : {
+    result, 
+    run<concurr::cxx11_thread>({1, 2, 2}), 
+    run<concurr::cxx11_thread>({1, 2, 2}, true)
+  })
+  {
+    if (world.rank() == 0) std::cerr << world.size() << " processes: " << res << " vs. " << expected << std::endl;
+    // summation order of the checksum depends on the number of processes
+    if (std::abs(res - expected) > 1e-12 * std::abs(expected)) 
+      throw std::runtime_error("result depends on the number of MPI processes");
+  }
+}
@@ -0,0 +1,259 @@
+/** 
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * @brief checks if the multigrid pressure solver (prs_scheme = mg, with and without
+ *        the Krylov acceleration), the FFT-based one (prs_scheme = fft, if built with FFTW and without MPI),
+ *        the pipelined conjugate residual one (prs_scheme = plcr)
+ *        and the preconditioned one with vertical line relaxation (prs_scheme = pc, pc_prcnd = vlr)
+ *        give non-divergent advector fields with the requested precision and the same flow
+ *        as the conjugate residual scheme, for different sets of boundary conditions
+ *        and grid sizes (setup based on the boussinesq test from the paper suite);
+ *        also checks if the mg and pc schemes give bit-for-bit identical results 
+ *        for different numbers of threads
+ */
+
+#include <libmpdata++/solvers/boussinesq.hpp>
+#include <libmpdata++/concurr/cxx11_thread.hpp>
+#include <cstdlib>
+
+using namespace libmpdataxx;
+
+template <solvers::prs_scheme_t prs_scheme_arg>
+struct ct_params_2d_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = 2 };
+  enum { n_eqns = 3 };
+  enum { rhs_scheme = solvers::trapez };
+  enum { prs_scheme = prs_scheme_arg };
+  struct ix { enum {
+    u, w, tht, 
+    vip_i=u, vip_j=w, vip_den=-1
+  }; };
+};
+
+template <solvers::prs_scheme_t prs_scheme_arg>
+struct ct_params_3d_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = 3 };
+  enum { n_eqns = 4 };
+  enum { rhs_scheme = solvers::trapez };
+  enum { prs_scheme = prs_scheme_arg };
+  struct ix { enum {
+    u, v, w, tht, 
+    vip_i=u, vip_j=v, vip_k=w, vip_den=-1
+  }; };
+};
+
+template <class ct_params_t>
+class div_check : public solvers::boussinesq<ct_params_t>
+{
+  using parent_t = solvers::boussinesq<ct_params_t>;
+
+  protected:
+
+  void hook_post_step() final
+  {
+    const auto gc_div = this->max_abs_vctr_div(this->mem->GC);
+    if (gc_div > 2 * this->prs_tol)
+    {
+      if (this->rank == 0) std::cerr << "prs_schemes: gc_div: " << gc_div << std::endl;
+      this->mem->barrier();
+      throw std::runtime_error("divergent advector");
+    }
+    // constant G, and hence the FFT-based solver is exact
+    if ((int)ct_params_t::prs_scheme == (int)solvers::fft && this->iters > 1)
+      throw std::runtime_error("more than one iteration of the fft pressure solver");
+    parent_t::hook_post_step();
+  }
+
+  public:
+
+  using parent_t::parent_t;
+};
+
+const double Tht_ref = 300, r0 = 250, dx = 10;
+const int nt = 10;
+
+// rt_params_t::mg_krylov exists only with prs_scheme = mg
+template <class rt_params_t>
+auto set_mg_krylov(rt_params_t &p, const bool mg_krylov, int) -> decltype(p.mg_krylov = mg_krylov, void())
+{
+  p.mg_krylov = mg_krylov;
+}
+
+template <class rt_params_t>
+void set_mg_krylov(rt_params_t &, const bool, long) {}
+
+// rt_params_t::pc_prcnd exists only with prs_scheme = pc
+template <class rt_params_t>
+auto set_pc(rt_params_t &p, const solvers::pc_prcnd_t prcnd, int) -> decltype(p.pc_prcnd = prcnd, void())
+{
+  p.pc_prcnd = prcnd;
+  p.pc_iters = prcnd == solvers::vlr ? 1 : 4;
+}
+
+template <class rt_params_t>
+void set_pc(rt_params_t &, const solvers::pc_prcnd_t, long) {}
+
+// n_threads > 0 overrides OMP_NUM_THREADS for a single run
+template <class ct_params_t, bcond::bcond_e bcx, bcond::bcond_e bcy>
+blitz::Array<double, 2> run_2d(
+  const int nx, const int ny, 
+  const bool mg_krylov = true, 
+  const solvers::pc_prcnd_t pc_prcnd = solvers::vlr,
+  const int n_threads = 0
+)
+{
+  using slv_t = div_check<ct_params_t>;
+  using ix = typename ct_params_t::ix;
+
+  typename slv_t::rt_params_t p;
+  p.dt = 7.5;
+  p.di = p.dj = dx; 
+  p.Tht_ref = Tht_ref; 
+  p.prs_tol = 1e-10;
+  p.grid_size = {nx, ny};
+  set_mg_krylov(p, mg_krylov, 0);
+  set_pc(p, pc_prcnd, 0);
+
+  const char *env_var = "OMP_NUM_THREADS";
+  const std::string env_val = std::getenv(env_var) != NULL ? std::getenv(env_var) : "";
+  if (n_threads > 0) setenv(env_var, std::to_string(n_threads).c_str(), 1);
+
+  concurr::cxx11_thread<
+    slv_t, 
+    bcx, bcx,
+    bcy, bcy
+  > slv(p);
+
+  if (n_threads > 0)
+  {
+    if (env_val.empty()) unsetenv(env_var);
+    else setenv(env_var, env_val.c_str(), 1);
+  }
+
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  slv.sclr_array("tht_e") = Tht_ref;
+  slv.advectee(ix::tht) = Tht_ref + where(
+    pow(i * dx - nx * dx / 2, 2) + pow(j * dx - 1.04 * r0, 2) <= pow(r0, 2), 
+    .5, 
+    0
+  );
+  slv.advectee(ix::u) = 0; 
+  slv.advectee(ix::w) = 0; 
+
+  slv.advance(nt);  
+  return slv.advectee(ix::w).copy();
+}
+
+template <class ct_params_t, bcond::bcond_e bcx, bcond::bcond_e bcz>
+blitz::Array<double, 3> run_3d(const int nx, const int ny, const int nz)
+{
+  using slv_t = div_check<ct_params_t>;
+  using ix = typename ct_params_t::ix;
+
+  typename slv_t::rt_params_t p;
+  p.dt = 7.5;
+  p.di = p.dj = p.dk = dx; 
+  p.Tht_ref = Tht_ref; 
+  p.prs_tol = 1e-10;
+  p.grid_size = {nx, ny, nz};
+  p.decomp = {2, 2, 1};
+  set_pc(p, solvers::vlr, 0);
+
+  concurr::cxx11_thread<
+    slv_t, 
+    bcx, bcx,
+    bcx, bcx,
+    bcz, bcz
+  > slv(p);
+
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  blitz::thirdIndex k;
+  slv.sclr_array("tht_e") = Tht_ref;
+  slv.advectee(ix::tht) = Tht_ref + where(
+    pow(i * dx - nx * dx / 2, 2) + pow(j * dx - ny * dx / 2, 2) + pow(k * dx - nz * dx / 3, 2) <= pow(nz * dx / 4, 2), 
+    .5, 
+    0
+  );
+  slv.advectee(ix::u) = 0; 
+  slv.advectee(ix::v) = 0; 
+  slv.advectee(ix::w) = 0; 
+
+  slv.advance(nt);  
+  return slv.advectee(ix::w).copy();
+}
+
+template <class arr_t>
+void check(const arr_t &a, const arr_t &b, const std::string &what)
+{
+  if (blitz::max(blitz::abs(a - b)) > 1e-6 * blitz::max(blitz::abs(b)))
+    throw std::runtime_error("prs_schemes: results differ from cr for " + what);
+}
+
+template <bcond::bcond_e bcx, bcond::bcond_e bcy>
+void test_2d(const int nx, const int ny, const std::string &what)
+{
+  const auto cr = run_2d<ct_params_2d_t<solvers::cr>, bcx, bcy>(nx, ny);
+  check(run_2d<ct_params_2d_t<solvers::mg>, bcx, bcy>(nx, ny, true), cr, what);
+  check(run_2d<ct_params_2d_t<solvers::mg>, bcx, bcy>(nx, ny, false), cr, what + " (stand-alone)");
+  check(run_2d<ct_params_2d_t<solvers::plcr>, bcx, bcy>(nx, ny), cr, what + " (plcr)");
+  check(run_2d<ct_params_2d_t<solvers::pc>, bcx, bcy>(nx, ny), cr, what + " (pc vlr)");
+#if defined(USE_FFTW) && !defined(USE_MPI)
+  check(run_2d<ct_params_2d_t<solvers::fft>, bcx, bcy>(nx, ny), cr, what + " (fft)");
+#endif
+}
+
+// the pressure solvers' operators read neighbouring subdomains' data and the reductions
+// are done in a fixed order, so the results should not depend on the number of threads
+template <class ct_params_t, bcond::bcond_e bcx, bcond::bcond_e bcy>
+void test_threads(
+  const int nx, const int ny, 
+  const bool mg_krylov, const solvers::pc_prcnd_t pc_prcnd, 
+  const std::string &what
+)
+{
+  const auto ref = run_2d<ct_params_t, bcx, bcy>(nx, ny, mg_krylov, pc_prcnd, 1);
+  for (int n_threads : {2, 3})
+  {
+    if (blitz::any(run_2d<ct_params_t, bcx, bcy>(nx, ny, mg_krylov, pc_prcnd, n_threads) != ref))
+      throw std::runtime_error(
+        "prs_schemes: results differ between 1 and " + std::to_string(n_threads) + " threads for " + what
+      );
+  }
+}
+
+template <bcond::bcond_e bcx, bcond::bcond_e bcz>
+void test_3d(const int nx, const int ny, const int nz, const std::string &what)
+{
+  const auto cr = run_3d<ct_params_3d_t<solvers::cr>, bcx, bcz>(nx, ny, nz);
+  check(run_3d<ct_params_3d_t<solvers::mg>, bcx, bcz>(nx, ny, nz), cr, what);
+  check(run_3d<ct_params_3d_t<solvers::plcr>, bcx, bcz>(nx, ny, nz), cr, what + " (plcr)");
+  check(run_3d<ct_params_3d_t<solvers::pc>, bcx, bcz>(nx, ny, nz), cr, what + " (pc vlr)");
+#if defined(USE_FFTW) && !defined(USE_MPI)
+  check(run_3d<ct_params_3d_t<solvers::fft>, bcx, bcz>(nx, ny, nz), cr, what + " (fft)");
+#endif
+}
+
+int main() 
+{
+  test_2d<bcond::cyclic, bcond::cyclic>(65, 65, "cyclic_cyclic");
+  test_2d<bcond::cyclic, bcond::rigid >(64, 41, "cyclic_rigid");
+  test_2d<bcond::open  , bcond::rigid >(51, 51, "open_rigid");
+  test_2d<bcond::rigid , bcond::rigid >(50, 50, "rigid_rigid");
+
+  test_threads<ct_params_2d_t<solvers::mg>, bcond::cyclic, bcond::rigid>(64, 41, true,  solvers::vlr,     "mg");
+  test_threads<ct_params_2d_t<solvers::mg>, bcond::cyclic, bcond::rigid>(64, 41, false, solvers::vlr,     "mg (stand-alone)");
+  test_threads<ct_params_2d_t<solvers::pc>, bcond::cyclic, bcond::rigid>(64, 41, true,  solvers::vlr,     "pc vlr");
+  test_threads<ct_params_2d_t<solvers::pc>, bcond::cyclic, bcond::rigid>(64, 41, true,  solvers::rchrdsn, "pc rchrdsn");
+
+  test_3d<bcond::cyclic, bcond::rigid >(33, 33, 25, "3d cyclic_rigid");
+  test_3d<bcond::rigid , bcond::rigid >(30, 26, 21, "3d rigid_rigid");
+}
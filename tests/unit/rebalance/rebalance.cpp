@@ -0,0 +1,88 @@
+/** 
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * @brief checks if with rt_params_t::rebalance_every set the slabs owning 
+ *        artificially expensive columns shrink, and if the results are 
+ *        the same as without domain decomposition
+ */
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/concurr/serial.hpp>
+#include <libmpdata++/concurr/cxx11_thread.hpp>
+
+using namespace libmpdataxx;
+
+struct ct_params_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = 2 };
+  enum { n_eqns = 1 };
+};
+
+const int nx = 32, ny = 8, nt = 40, n_slabs = 4, expensive = nx / n_slabs;
+
+std::array<int, n_slabs> widths;
+
+// solver with some extra work done for columns with i < expensive
+// (mimicking e.g. a sponge layer along the left edge of the domain)
+template <class ct_params_t>
+class slow_edge : public solvers::mpdata<ct_params_t>
+{
+  using parent_t = solvers::mpdata<ct_params_t>;
+
+  protected:
+
+  void hook_post_step()
+  {
+    parent_t::hook_post_step();
+    volatile double x = 0;
+    for (int c = this->i.first(); c <= std::min(this->i.last(), expensive - 1); ++c)
+      for (int it = 0; it < 200000; ++it) x = x + 1;
+    widths[this->rank] = this->i.length();
+  }
+
+  public:
+
+  using parent_t::parent_t;
+};
+
+template <class run_t>
+void init(run_t &run)
+{
+  run.advectee() = 0;
+  run.advectee()(rng_t(4, 12), rng_t(2, 5)) = 1;
+  run.advector(0) = .3;
+  run.advector(1) = -.2;
+}
+
+int main()
+{
+  using solver_t = slow_edge<ct_params_t>;
+
+  typename solver_t::rt_params_t p;
+  p.grid_size = {nx, ny};
+
+  concurr::serial<solver_t, bcond::cyclic, bcond::cyclic, bcond::cyclic, bcond::cyclic> ref(p);
+  init(ref);
+  ref.advance(nt);
+
+  p.decomp = {n_slabs, 1};
+  p.rebalance_every = 5;
+  concurr::cxx11_thread<solver_t, bcond::cyclic, bcond::cyclic, bcond::cyclic, bcond::cyclic> run(p);
+  init(run);
+  run.advance(nt / 2);
+  run.advance(nt / 2);
+
+  if (blitz::any(ref.advectee() != run.advectee()))
+    throw std::runtime_error("results differ with rebalancing");
+
+  int sum = 0;
+  for (const auto &w : widths) sum += w;
+  if (sum != nx) 
+    throw std::runtime_error("slabs do not cover the domain");
+  if (widths[0] >= expensive) 
+    throw std::runtime_error("slab with the expensive columns did not shrink");
+}
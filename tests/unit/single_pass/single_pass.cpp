@@ -0,0 +1,104 @@
+/** 
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * @brief checks if the single-pass corrective iteration (rt_params_t::single_pass)
+ *        gives the same results as the default setting in 2D and 3D, also with rigid walls
+ *        (zero-flux conditions applied within the single-pass loop)
+ */
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/concurr/cxx11_thread.hpp>
+
+using namespace libmpdataxx;
+
+template <int n_dims_arg, int opts_arg>
+struct ct_params_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = n_dims_arg };
+  enum { n_eqns = 1 };
+  enum { opts = opts_arg };
+};
+
+const int nx = 16, ny = 12, nz = 10, nt = 10;
+
+template <int opts_arg, bcond::bcond_e bcx>
+blitz::Array<double, 2> run_2d(const int n_iters, const bool single_pass)
+{
+  using solver_t = solvers::mpdata<ct_params_t<2, opts_arg>>;
+  typename solver_t::rt_params_t p;
+  p.grid_size = {nx, ny};
+  p.n_iters = n_iters;
+  p.single_pass = single_pass;
+
+  concurr::cxx11_thread<
+    solver_t, 
+    bcx, bcx,
+    bcond::rigid, bcond::rigid
+  > slv(p);
+
+  slv.advectee() = 1;
+  slv.advectee()(rng_t(2, 6), rng_t(3, 7)) = 2;
+  slv.advector(0) = .2;
+  slv.advector(1) = -.3;
+
+  slv.advance(nt);
+  return slv.advectee().copy();
+}
+
+template <int opts_arg, bcond::bcond_e bcx>
+blitz::Array<double, 3> run_3d(const int n_iters, const bool single_pass)
+{
+  using solver_t = solvers::mpdata<ct_params_t<3, opts_arg>>;
+  typename solver_t::rt_params_t p;
+  p.grid_size = {nx, ny, nz};
+  p.decomp = {2, 2, 1};
+  p.n_iters = n_iters;
+  p.single_pass = single_pass;
+
+  concurr::cxx11_thread<
+    solver_t, 
+    bcx, bcx,
+    bcond::rigid, bcond::rigid,
+    bcond::cyclic, bcond::cyclic
+  > slv(p);
+
+  slv.advectee() = 1;
+  slv.advectee()(rng_t(2, 6), rng_t(3, 7), rng_t(1, 4)) = 2;
+  slv.advector(0) = .2;
+  slv.advector(1) = -.3;
+  slv.advector(2) = .1;
+
+  slv.advance(nt);
+  return slv.advectee().copy();
+}
+
+// the same operations in the same order, but possibly contracted differently by the compiler
+template <class arr_t>
+void check(const arr_t &a, const arr_t &b)
+{
+  if (blitz::max(blitz::abs(a - b)) > 1e-12)
+    throw std::runtime_error("results differ with single-pass iterations");
+}
+
+template <int opts_arg, bcond::bcond_e bcx>
+void test(const int n_iters)
+{
+  check(run_2d<opts_arg, bcx>(n_iters, false), run_2d<opts_arg, bcx>(n_iters, true));
+  check(run_3d<opts_arg, bcx>(n_iters, false), run_3d<opts_arg, bcx>(n_iters, true));
+}
+
+int main()
+{
+  for (int n_iters : {1, 2, 3})
+  {
+    test<0, bcond::cyclic>(n_iters);
+    test<0, bcond::rigid>(n_iters);
+    test<opts::abs | opts::dfl, bcond::rigid>(n_iters);
+    test<opts::tot | opts::khn, bcond::cyclic>(n_iters);
+  }
+  test<opts::iga, bcond::rigid>(2); // not done in a single pass
+}
@@ -0,0 +1,75 @@
+/** 
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ *
+ * @brief checks if the tiled execution of 3D MPDATA iterations (rt_params_t::tiled)
+ *        gives the same results as the default setting, also with rigid walls
+ *        (zero-flux conditions applied to the tiles touching them)
+ */
+
+// small tiles so that the subdomains are split into several of them
+#define LIBMPDATAXX_TILE_BYTES 4096
+
+#include <libmpdata++/solvers/mpdata.hpp>
+#include <libmpdata++/concurr/cxx11_thread.hpp>
+
+using namespace libmpdataxx;
+
+template <int opts_arg>
+struct ct_params_t : ct_params_default_t
+{
+  using real_t = double;
+  enum { n_dims = 3 };
+  enum { n_eqns = 1 };
+  enum { opts = opts_arg };
+};
+
+const int nx = 16, ny = 12, nz = 10, nt = 10;
+
+template <int opts_arg, bcond::bcond_e bcx>
+blitz::Array<double, 3> run(const int n_iters, const bool tiled)
+{
+  using solver_t = solvers::mpdata<ct_params_t<opts_arg>>;
+  typename solver_t::rt_params_t p;
+  p.grid_size = {nx, ny, nz};
+  p.decomp = {2, 2, 1};
+  p.n_iters = n_iters;
+  p.tiled = tiled;
+
+  concurr::cxx11_thread<
+    solver_t, 
+    bcx, bcx,
+    bcond::rigid, bcond::rigid,
+    bcond::cyclic, bcond::cyclic
+  > slv(p);
+
+  slv.advectee() = 1;
+  slv.advectee()(rng_t(2, 6), rng_t(3, 7), rng_t(1, 4)) = 2;
+  slv.advector(0) = .2;
+  slv.advector(1) = -.3;
+  slv.advector(2) = .1;
+
+  slv.advance(nt);
+  return slv.advectee().copy();
+}
+
+template <int opts_arg, bcond::bcond_e bcx>
+void test(const int n_iters)
+{
+  if (blitz::any(run<opts_arg, bcx>(n_iters, false) != run<opts_arg, bcx>(n_iters, true)))
+    throw std::runtime_error("results differ with tiled iterations");
+}
+
+int main()
+{
+  for (int n_iters : {1, 2, 3})
+  {
+    test<0, bcond::cyclic>(n_iters);
+    test<0, bcond::rigid>(n_iters);
+    test<opts::abs | opts::dfl, bcond::rigid>(n_iters);
+  }
+  test<opts::iga, bcond::cyclic>(2); // infinite gauge uses a single corrective iteration
+  test<opts::iga, bcond::rigid>(2);
+}